@@ -0,0 +1,327 @@
+// Timings of the catalog, distance, dispatch and rendering hot paths at
+// several data sizes, written as CSV so runs from different releases can
+// be kept and compared.
+//
+// Build from this folder:
+//   g++ -std=c++17 -O2 -I../ride_app_source hot_path_benchmark.cpp
+//       ../ride_app_source/city_catalog.cpp ../ride_app_source/csv_reader.cpp
+//       ../ride_app_source/mapped_file.cpp ../ride_app_source/name_index.cpp
+//       ../ride_app_source/distance_calculator.cpp ../ride_app_source/fuzzy_matcher.cpp
+//       ../ride_app_source/prefix_index.cpp ../ride_app_source/spatial_index.cpp
+//       ../ride_app_source/transit_router.cpp ../ride_app_source/rail_lines.cpp
+//       ../ride_app_source/driver_manager.cpp ../ride_app_source/driver_grid.cpp
+//       ../ride_app_source/ride_store.cpp ../ride_app_source/ride_journal.cpp
+//       ../ride_app_source/ride_table.cpp ../ride_app_source/ride_grouping.cpp
+//       -o hot_path_benchmark -pthread
+//
+// Run from the repository root:
+//   hot_path_benchmark [--scales 100,10000,100000,1000000] [--repeat 3] > results.csv
+//
+// One row per case and scale: case,rows,ops,best_ms,ns_per_op. rows is
+// the size of the data the case runs on, ops the calls timed, and best_ms
+// the fastest of the repeats. Progress goes to stderr.
+
+#include "city_catalog.h"
+#include "distance_calculator.h"
+#include "driver_manager.h"
+#include "ride_store.h"
+#include "ride_table.h"
+#include "ride_grouping.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+#ifdef _WIN32
+static const char* NULL_DEVICE = "NUL";
+#else
+static const char* NULL_DEVICE = "/dev/null";
+#endif
+
+// Calls per timed run for cases whose cost doesn't depend on rows, so
+// small scales still time long enough to be steady
+static constexpr size_t MIN_OPS = 1000000;
+
+struct Options {
+    vector<size_t> scales = {100, 10000, 100000, 1000000};
+    int repeat = 3;
+};
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Time run() `repeat` times and write its row
+static void measure(const Options& options, const char* name, size_t rows, size_t ops,
+                    const function<void()>& run) {
+    double best = -1;
+    for (int i = 0; i < options.repeat; ++i) {
+        auto start = chrono::steady_clock::now();
+        run();
+        double ms = elapsedMs(start);
+        if (best < 0 || ms < best) best = ms;
+    }
+    printf("%s,%zu,%zu,%.3f,%.1f\n", name, rows, ops, best, best * 1e6 / static_cast<double>(ops));
+    fflush(stdout);
+}
+
+static bool parseScales(const char* text, vector<size_t>& scales) {
+    scales.clear();
+    stringstream list(text);
+    string item;
+    while (getline(list, item, ',')) {
+        char* end;
+        unsigned long long value = strtoull(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value == 0) return false;
+        scales.push_back(static_cast<size_t>(value));
+    }
+    return !scales.empty();
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--scales") == 0 && hasValue) {
+            if (!parseScales(argv[++i], options.scales)) return false;
+        } else if (strcmp(argv[i], "--repeat") == 0 && hasValue) {
+            options.repeat = atoi(argv[++i]);
+            if (options.repeat < 1) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A Data_Csv-like folder holding `count` places in Cities.csv, with the
+// other catalog files present but empty. Names are unique once normalized.
+static void writeCatalogFolder(const fs::path& dir, size_t count) {
+    static const char* WORDS[] = {"Poblacion", "San Isidro", "Santo Nino", "Bagong Silang", "Malanday",
+                                  "San Roque", "Mabini", "Santa Cruz"};
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    mt19937 rng(21);
+    uniform_real_distribution<double> lat(14.35, 14.80), lon(120.90, 121.15);
+    ofstream cities(dir / "Cities.csv");
+    cities << "City,Latitude,Longitude\n";
+    char row[96];
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(row, sizeof(row), "Barangay %zu %s,%.6f,%.6f\n", i, WORDS[rng() % 8], lat(rng), lon(rng));
+        cities << row;
+    }
+    for (const char* file : {"Ejeep.csv", "LRT-2.csv", "LRT.csv", "Major_Bus.csv", "MRT-3.csv", "PNR.csv"}) {
+        ofstream(dir / file) << "Station,Latitude,Longitude\n";
+    }
+}
+
+// loadAllCities() from CSV, then the same folder from its snapshot
+static void benchmarkCatalogLoad(const Options& options, size_t rows, const fs::path& dir) {
+    writeCatalogFolder(dir, rows);
+    measure(options, "load_cities_csv", rows, rows, [&] { CityCatalog catalog(dir.string()); });
+
+    {
+        CityCatalog catalog(dir.string());
+        catalog.saveSnapshot(catalog.snapshotPath());
+    }
+    measure(options, "load_cities_snapshot", rows, rows, [&] {
+        CityCatalog catalog(dir.string());
+        if (!catalog.loadedFromSnapshot()) cerr << "Warning: snapshot was not used at " << rows << " rows\n";
+    });
+}
+
+// findCity() hitting on the exact name, on padded input and on input
+// that only matches once normalized
+static void benchmarkFindCity(const Options& options, size_t rows, const fs::path& dir) {
+    const size_t queries = 200000;
+    CityCatalog catalog(dir.string());
+    DistanceCalculator calculator;
+
+    mt19937 rng(22);
+    vector<string> exact, padded, normalized;
+    for (size_t i = 0; i < queries; ++i) {
+        string name(catalog.cities()[rng() % catalog.size()].name);
+        padded.push_back("  " + name + " ");
+        string upper = name;
+        transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        normalized.push_back(upper);
+        exact.push_back(move(name));
+    }
+
+    size_t misses = 0;
+    auto lookups = [&](const vector<string>& names) {
+        return [&] {
+            for (const string& name : names) {
+                if (!calculator.findCity(catalog, name)) ++misses;
+            }
+        };
+    };
+    measure(options, "find_city_exact", rows, queries, lookups(exact));
+    measure(options, "find_city_trimmed", rows, queries, lookups(padded));
+    measure(options, "find_city_normalized", rows, queries, lookups(normalized));
+    if (misses) cerr << "Warning: " << misses << " lookups missed at " << rows << " rows\n";
+}
+
+// calculateDistance() between neighbours in a catalog of `rows` places
+static void benchmarkDistance(const Options& options, size_t rows) {
+    mt19937 rng(23);
+    uniform_real_distribution<double> lat(14.35, 14.80), lon(120.90, 121.15);
+    vector<City> cities;
+    cities.reserve(rows + 1);
+    for (size_t i = 0; i <= rows; ++i) cities.push_back({"Place", lat(rng), lon(rng)});
+
+    DistanceCalculator calculator;
+    size_t ops = max(rows, MIN_OPS);
+    double total = 0;
+    measure(options, "calculate_distance", rows, ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            size_t at = i % rows;
+            total += calculator.calculateDistance(cities[at], cities[at + 1]);
+        }
+    });
+    if (total < 0) cerr << total;
+}
+
+// assignDriver() + releaseDriver() pairs on a fleet of `rows` drivers,
+// most of them busy
+static void benchmarkAssignRelease(const Options& options, size_t rows) {
+    static const char* VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus", "Train"};
+    DriverManager dm;
+    dm.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        dm.addDriver(static_cast<int>(i + 1), "Driver", "09000000000", VEHICLES[i % 7]);
+    }
+    for (size_t i = 0; i + 7 < rows; ++i) dm.assignDriver(VEHICLES[i % 7]);
+
+    size_t ops = MIN_OPS;
+    size_t misses = 0;
+    measure(options, "assign_release_driver", rows, ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            Driver* driver = dm.assignDriver(VEHICLES[i % 7]);
+            if (!driver) {
+                ++misses;
+                continue;
+            }
+            dm.releaseDriver(driver->id);
+        }
+    });
+    if (misses) cerr << "Warning: " << misses << " assigns found no driver at " << rows << " rows\n";
+}
+
+// countDuplicateVectors() over `rows` rides' vehicle lists, about one in
+// ten a copy of another
+static void benchmarkDuplicates(const Options& options, size_t rows) {
+    static const char* VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus", "Train"};
+    mt19937 rng(24);
+    list<vector<string>> data;
+    size_t distinct = max<size_t>(rows - rows / 10, 1);
+    for (size_t i = 0; i < rows; ++i) {
+        size_t group = i < distinct ? i : rng() % distinct;
+        vector<string> vehicles;
+        for (size_t v = 0; v < 3; ++v) vehicles.push_back(VEHICLES[(group >> (3 * v)) % 7]);
+        vehicles.push_back(to_string(group));
+        data.push_back(move(vehicles));
+    }
+
+    ofstream sink(NULL_DEVICE);
+    measure(options, "count_duplicate_vectors", rows, rows, [&] { countDuplicateVectors(data, sink); });
+}
+
+// The view_all_rides() table for `rows` rides, whole and one page, written
+// to the null device
+static void benchmarkRender(const Options& options, size_t rows) {
+    static const char* FIRST[] = {"Juan", "Maria", "Jose", "Ana", "Pedro", "Rosa", "Carlo", "Liza"};
+    static const char* LAST[] = {"Dela Cruz", "Santos", "Reyes", "Bautista", "Garcia", "Mendoza"};
+    const uint32_t places = static_cast<uint32_t>(max<size_t>(CityCatalog::instance().size(), 1));
+
+    mt19937 rng(25);
+    RideStore rides;
+    rides.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        person p;
+        p.ride_id = to_string(1700000000 + i / 4) + "_" + to_string(i % 4);
+        p.fname = FIRST[rng() % 8];
+        p.lname = LAST[rng() % 6];
+        p.phone = "0917" + to_string(1000000 + rng() % 9000000);
+        p.pickup = rng() % places;
+        p.dropoff = rng() % places;
+        p.setDate(1 + rng() % 28, 1 + rng() % 12, 2025);
+        p.vehicle = static_cast<VehicleType>(rng() % VEHICLE_TYPE_COUNT);
+        p.status = static_cast<RideStatus>(rng() % RIDE_STATUS_COUNT);
+        rides.add(move(p));
+    }
+
+    ofstream sink(NULL_DEVICE);
+    measure(options, "render_ride_table", rows, rows, [&] { printRideTable(rides, sink); });
+
+    // The last page, the one furthest from the start of the store
+    RideTable table(rides);
+    size_t pages = table.pageCount();
+    size_t pageRows = min(rows, RideTable::PAGE_ROWS);
+    measure(options, "render_ride_table_page", rows, pageRows, [&] { table.printPage(sink, pages - 1); });
+}
+
+// Shared-ride grouping, as onride() does it, over `rows` active rides on
+// one day
+static void benchmarkGrouping(const Options& options, size_t rows) {
+    const uint32_t places = static_cast<uint32_t>(max<size_t>(CityCatalog::instance().size(), 1));
+    static const RideStatus ACTIVE[] = {RideStatus::Pending, RideStatus::Confirmed, RideStatus::OnRide};
+
+    mt19937 rng(26);
+    RideStore rides;
+    rides.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        person p;
+        p.ride_id = to_string(i);
+        p.pickup = rng() % places;
+        p.dropoff = rng() % places;
+        p.setDate(17, 10, 2026);
+        p.vehicle = static_cast<VehicleType>(rng() % VEHICLE_TYPE_COUNT);
+        p.status = ACTIVE[rng() % 3];
+        rides.add(move(p));
+    }
+
+    size_t groups = 0;
+    measure(options, "group_shared_rides", rows, rows, [&] {
+        RideGroups grouped(rides, {RideStatus::OnRide, RideStatus::Confirmed, RideStatus::Pending});
+        groups += grouped.size();
+    });
+    if (groups == 0) cerr << "Warning: no groups at " << rows << " rows\n";
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: " << argv[0] << " [--scales n,n,...] [--repeat n]\n";
+        return 2;
+    }
+
+    const fs::path dir = fs::temp_directory_path() / "ride_app_hot_path_catalog";
+    printf("case,rows,ops,best_ms,ns_per_op\n");
+    for (size_t rows : options.scales) {
+        cerr << "Scale " << rows << "\n";
+        benchmarkCatalogLoad(options, rows, dir);
+        benchmarkFindCity(options, rows, dir);
+        benchmarkDistance(options, rows);
+        benchmarkAssignRelease(options, rows);
+        benchmarkDuplicates(options, rows);
+        benchmarkGrouping(options, rows);
+        benchmarkRender(options, rows);
+    }
+    fs::remove_all(dir);
+    return 0;
+}
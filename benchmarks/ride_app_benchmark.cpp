@@ -0,0 +1,712 @@
+// Performance checks for the ride app's hot paths.
+//
+// Build from this folder (add -mavx2 to measure the vectorized kernels):
+//   g++ -std=c++17 -O2 -I../ride_app_source ride_app_benchmark.cpp
+//       ../ride_app_source/distance_calculator.cpp ../ride_app_source/batch_distance.cpp
+//       ../ride_app_source/city_catalog.cpp ../ride_app_source/name_index.cpp
+//       ../ride_app_source/fuzzy_matcher.cpp ../ride_app_source/prefix_index.cpp
+//       ../ride_app_source/spatial_index.cpp ../ride_app_source/csv_reader.cpp
+//       ../ride_app_source/mapped_file.cpp ../ride_app_source/transit_router.cpp
+//       ../ride_app_source/rail_lines.cpp ../ride_app_source/driver_manager.cpp
+//       ../ride_app_source/driver_grid.cpp ../ride_app_source/batch_dispatcher.cpp
+//       ../ride_app_source/ride_store.cpp ../ride_app_source/ride_journal.cpp
+//       ../ride_app_source/distance_matrix.cpp ../ride_app_source/ride_service.cpp
+//       ../ride_app_source/command_mode.cpp ../ride_app_source/calendar_picker.cpp
+//       -o ride_app_benchmark -pthread
+
+#include "distance_calculator.h"
+#include "batch_distance.h"
+#include "transit_router.h"
+#include "rail_lines.h"
+#include "driver_manager.h"
+#include "batch_dispatcher.h"
+#include "ride_store.h"
+#include "ride_journal.h"
+#include "command_mode.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Random unnamed places spread over Metro Manila
+static vector<City> randomCities(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> lat(14.35, 14.80), lon(120.90, 121.15);
+    vector<City> cities;
+    cities.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        cities.push_back({"Place", lat(rng), lon(rng)});
+    }
+    return cities;
+}
+
+// One-to-many distances: batched kernel against calculateDistance()
+static void benchmarkDistances() {
+    const size_t points = 100000;
+    const size_t queries = 200;
+
+    vector<City> cities = randomCities(points, 1);
+    GeoPoints geo = GeoPoints::fromCities(cities);
+    DistanceCalculator calculator;
+    vector<double> scalar(points), batched(points);
+
+    double scalarMs = 0, batchedMs = 0, maxError = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        const City& from = cities[q * (points / queries)];
+
+        auto start = chrono::steady_clock::now();
+        for (size_t j = 0; j < points; ++j) {
+            scalar[j] = calculator.calculateDistance(from, cities[j]);
+        }
+        scalarMs += elapsedMs(start);
+
+        start = chrono::steady_clock::now();
+        distancesFrom(geo, from.lat, from.lon, batched.data());
+        batchedMs += elapsedMs(start);
+
+        for (size_t j = 0; j < points; ++j) {
+            maxError = max(maxError, fabs(scalar[j] - batched[j]));
+        }
+    }
+
+    double pairs = static_cast<double>(points) * queries;
+    cout << fixed << setprecision(2);
+    cout << "\n=== Distance: one-to-many, " << points << " points x " << queries << " queries ===\n";
+    cout << "Kernel: " << (batchDistanceVectorized() ? "AVX2" : "scalar") << "\n";
+    cout << "calculateDistance(): " << scalarMs << " ms (" << pairs / scalarMs / 1000 << " M pairs/s)\n";
+    cout << "distancesFrom():     " << batchedMs << " ms (" << pairs / batchedMs / 1000 << " M pairs/s)\n";
+    cout << "Speedup: " << scalarMs / batchedMs << "x\n";
+    cout << setprecision(3) << "Max abs error: " << maxError * 1000 << " m (bound 1 m)\n";
+}
+
+// Routes between every pair of network stops in Data_Csv
+static void benchmarkTransit() {
+    const CityCatalog& catalog = CityCatalog::instance();
+    auto start = chrono::steady_clock::now();
+    const TransitRouter& router = TransitRouter::instance();
+    double buildMs = elapsedMs(start);
+
+    vector<const City*> stops;
+    for (const auto& city : catalog.cities()) {
+        if (router.isStop(city)) stops.push_back(&city);
+    }
+
+    size_t routes = 0, found = 0;
+    double totalKm = 0;
+    start = chrono::steady_clock::now();
+    for (const City* from : stops) {
+        for (const City* to : stops) {
+            TransitRouter::Route route = router.route(*from, *to);
+            ++routes;
+            if (route.found) {
+                ++found;
+                totalKm += route.km;
+            }
+        }
+    }
+    double queryMs = elapsedMs(start);
+
+    cout << fixed << setprecision(2);
+    cout << "\n=== Transit: " << stops.size() << " stops, " << router.edgeCount() << " edges ===\n";
+    cout << "Build: " << buildMs << " ms\n";
+    cout << "Routes: " << routes << " (" << found << " found, avg " << (found ? totalKm / found : 0) << " km)\n";
+    cout << "Per query: " << queryMs * 1000 / max<size_t>(routes, 1) << " us\n";
+}
+
+// Prices random same-line station pairs: summing the hops per trip
+// against the prefix-sum table
+static void benchmarkRailFares() {
+    const CityCatalog& catalog = CityCatalog::instance();
+    const RailLines& lines = RailLines::instance();
+    const auto& cities = catalog.cities();
+    DistanceCalculator calculator;
+
+    vector<uint32_t> stations;
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        if (lines.isStation(cities[id])) stations.push_back(id);
+    }
+    if (stations.empty()) return;
+
+    const size_t trips = 1000000;
+    mt19937 rng(7);
+    uniform_int_distribution<size_t> pick(0, stations.size() - 1);
+    vector<uint32_t> from, to;
+    while (from.size() < trips) {
+        uint32_t a = stations[pick(rng)], b = stations[pick(rng)];
+        if (cities[a].source != cities[b].source) continue;
+        from.push_back(a);
+        to.push_back(b);
+    }
+
+    const VehicleRate& rate = DistanceCalculator::VEHICLE_RATES.at("Train");
+    vector<double> summed(trips), batched(trips);
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < trips; ++i) {
+        uint32_t a = min(from[i], to[i]), b = max(from[i], to[i]);
+        double km = 0;
+        for (uint32_t id = a; id < b; ++id) km += calculator.calculateDistance(cities[id], cities[id + 1]);
+        summed[i] = rate.baseFare + rate.perKmRate * km;
+    }
+    double summedMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    lines.priceTrips(from.data(), to.data(), trips, rate, batched.data());
+    double batchedMs = elapsedMs(start);
+
+    double maxError = 0;
+    for (size_t i = 0; i < trips; ++i) maxError = max(maxError, fabs(summed[i] - batched[i]));
+
+    cout << fixed << setprecision(2);
+    cout << "\n=== Rail fares: " << trips << " same-line trips ===\n";
+    cout << "Summing hops:  " << summedMs << " ms\n";
+    cout << "priceTrips():  " << batchedMs << " ms (" << trips / batchedMs / 1000 << " M trips/s)\n";
+    cout << "Speedup: " << summedMs / batchedMs << "x\n";
+    cout << setprecision(6) << "Max fare difference: " << maxError << "\n";
+}
+
+// Assign/release latency as the fleet grows; the cost should stay flat
+static void benchmarkDispatch() {
+    static const char* VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus", "Train"};
+    const size_t fleets[] = {7, 1000, 100000, 1000000};
+    const size_t operations = 1000000;
+
+    cout << "\n=== Dispatch: assign + release ===\n";
+    cout << setw(10) << "Drivers" << setw(14) << "ns per pair" << "\n";
+    for (size_t fleet : fleets) {
+        DriverManager dm;
+        dm.reserve(fleet);
+        for (size_t i = 0; i < fleet; ++i) {
+            dm.addDriver(static_cast<int>(i + 1), "Driver", "09000000000", VEHICLES[i % 7]);
+        }
+
+        // Keep most of the fleet busy so free drivers are far from the front
+        vector<int> busy;
+        for (size_t i = 0; i + 7 < fleet; ++i) busy.push_back(dm.assignDriver(VEHICLES[i % 7])->id);
+
+        size_t missed = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < operations; ++i) {
+            Driver* driver = dm.assignDriver(VEHICLES[i % 7]);
+            if (!driver) {
+                ++missed;
+                continue;
+            }
+            dm.releaseDriver(driver->id);
+        }
+        double ms = elapsedMs(start);
+
+        cout << setw(10) << fleet << setw(14) << fixed << setprecision(1) << ms * 1e6 / operations;
+        if (missed) cout << "  (" << missed << " misses)";
+        cout << "\n";
+    }
+}
+
+// Loads a generated roster shaped like Data_Csv/drivers.csv
+static void benchmarkRosterLoad() {
+    const size_t rows = 1000000;
+    string path = (filesystem::temp_directory_path() / "ride_app_roster.csv").string();
+    {
+        ofstream out(path);
+        out << "rider_id,name,phone,age,rating,license_plate\n";
+        mt19937 rng(11);
+        for (size_t i = 0; i < rows; ++i) {
+            out << 1001 + i << ",Driver " << rng() % 100000 << ",9" << 100000000 + rng() % 900000000
+                << "," << 20 + rng() % 45 << "," << 3 + (rng() % 21) / 10.0 << ",ABC " << rng() % 1000 << "\n";
+        }
+    }
+
+    size_t loaded;
+    double ms;
+    {
+        // The manager keeps the file mapped, so drop it before deleting
+        DriverManager dm;
+        auto start = chrono::steady_clock::now();
+        loaded = dm.loadFromCsv(path);
+        ms = elapsedMs(start);
+    }
+    remove(path.c_str());
+
+    cout << fixed << setprecision(2);
+    cout << "\n=== Roster load: " << loaded << " drivers ===\n";
+    cout << "loadFromCsv(): " << ms << " ms (" << loaded / ms / 1000 << " M rows/s)\n";
+}
+
+// Nearest-driver dispatch over a moving fleet spread across Metro Manila,
+// checked against a scan of every free driver
+static void benchmarkNearestDispatch() {
+    static const char* VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus"};
+    const size_t fleet = 50000;
+    const size_t queries = 100000;
+    const size_t movesPerQuery = 10;
+    DistanceCalculator calculator;
+
+    mt19937 rng(3);
+    uniform_real_distribution<double> latDist(14.40, 14.80), lonDist(120.90, 121.15);
+    DriverManager dm;
+    dm.reserve(fleet);
+    for (size_t i = 0; i < fleet; ++i) {
+        int id = static_cast<int>(i + 1);
+        dm.addDriver(id, "Driver", "09000000000", VEHICLES[i % 6]);
+        dm.updateLocation(id, latDist(rng), lonDist(rng));
+    }
+
+    size_t checked = 0, mismatches = 0;
+    double totalKm = 0;
+    uniform_int_distribution<int> anyDriver(1, static_cast<int>(fleet));
+    uniform_real_distribution<double> step(-0.001, 0.001);   // up to ~100 m
+    auto start = chrono::steady_clock::now();
+    for (size_t q = 0; q < queries; ++q) {
+        // Drivers keep moving between requests
+        for (size_t m = 0; m < movesPerQuery; ++m) {
+            const Driver* moving = dm.findDriver(anyDriver(rng));
+            dm.updateLocation(moving->id, moving->lat + step(rng), moving->lon + step(rng));
+        }
+
+        const char* vehicle = VEHICLES[q % 6];
+        double lat = latDist(rng), lon = lonDist(rng), km;
+        Driver* driver = dm.assignNearestDriver(vehicle, lat, lon, &km);
+        totalKm += km;
+
+        if (q % 1000 == 0) {
+            City pickup = {"Pickup", lat, lon};
+            double bestKm = INFINITY;
+            for (const auto& other : dm.getDrivers()) {
+                if (!other.available || other.vehicle != vehicle) continue;
+                bestKm = min(bestKm, calculator.calculateDistance(pickup, {"Driver", other.lat, other.lon}));
+            }
+            ++checked;
+            if (km > bestKm + 0.01) ++mismatches;
+        }
+        dm.releaseDriver(driver->id);
+    }
+    double ms = elapsedMs(start);
+
+    cout << fixed << setprecision(2);
+    cout << "\n=== Nearest dispatch: " << fleet << " moving drivers ===\n";
+    cout << "Per request (" << movesPerQuery << " moves + assign + release): " << ms * 1000 / queries << " us\n";
+    cout << "Average pickup distance: " << totalKm / queries << " km\n";
+    cout << "Checked against a full scan: " << checked << " (" << mismatches << " farther than the nearest)\n";
+}
+
+// Peak-hour batches: optimal matching against greedy on the same requests
+static void benchmarkBatchDispatch() {
+    static const char* VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus"};
+    const size_t fleet = 50000;
+    const size_t batches[] = {60, 600, 2400, 12000};
+
+    mt19937 rng(5);
+    uniform_real_distribution<double> latDist(14.40, 14.80), lonDist(120.90, 121.15);
+    DriverManager dm;
+    dm.reserve(fleet);
+    for (size_t i = 0; i < fleet; ++i) {
+        int id = static_cast<int>(i + 1);
+        dm.addDriver(id, "Driver", "09000000000", VEHICLES[i % 6]);
+        dm.updateLocation(id, latDist(rng), lonDist(rng));
+    }
+
+    // Demand clusters around a few hotspots, as at rush hour
+    normal_distribution<double> spread(0.0, 0.01);
+    vector<pair<double, double>> hotspots;
+    for (int h = 0; h < 8; ++h) hotspots.push_back({latDist(rng), lonDist(rng)});
+
+    cout << "\n=== Batch dispatch: " << fleet << " drivers ===\n";
+    cout << setw(8) << "Rides" << setw(10) << "Solver" << setw(12) << "Latency ms"
+         << setw(14) << "Total km" << setw(14) << "Greedy km" << setw(10) << "Saved" << "\n";
+    BatchDispatcher dispatcher(dm);
+    for (size_t batch : batches) {
+        vector<BatchDispatcher::Request> requests;
+        for (size_t r = 0; r < batch; ++r) {
+            const auto& spot = hotspots[rng() % hotspots.size()];
+            requests.push_back({VEHICLES[r % 6], spot.first + spread(rng), spot.second + spread(rng)});
+        }
+
+        BatchDispatcher::Result result = dispatcher.dispatch(requests);
+        for (int id : result.driverIds) {
+            if (id != -1) dm.releaseDriver(id);
+        }
+
+        cout << setw(8) << batch << setw(10) << (result.exact ? "exact" : "greedy")
+             << setw(12) << fixed << setprecision(2) << result.milliseconds
+             << setw(14) << result.totalKm << setw(14) << result.greedyKm
+             << setw(9) << setprecision(1) << 100.0 * (1 - result.totalKm / result.greedyKm) << "%\n";
+    }
+}
+
+static string lowerCopy(const string& text) {
+    string lower = text;
+    transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower;
+}
+
+static void benchmarkRideStore() {
+    static const char* FIRST[] = {"Juan", "Maria", "Jose", "Ana", "Pedro", "Rosa", "Carlo", "Liza"};
+    const size_t count = 1000000;
+    const size_t queries = 200;
+
+    mt19937 rng(9);
+    vector<person> source;
+    source.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        person p;
+        p.ride_id = to_string(100000000 + i);
+        p.num_of_persons = 1;
+        p.fname = string(FIRST[rng() % 8]) + to_string(rng() % 20000);
+        p.lname = "Santos" + to_string(rng() % 5000);
+        p.pickup = 0;
+        p.dropoff = 1;
+        p.setDate(1 + rng() % 28, 1 + rng() % 12, 2025);
+        p.vehicle = VehicleType::Sedan;
+        p.status = static_cast<RideStatus>(rng() % RIDE_STATUS_COUNT);
+        source.push_back(p);
+    }
+
+    auto start = chrono::steady_clock::now();
+    RideStore store;
+    store.reserve(count);
+    for (const person& p : source) store.add(p);
+    double loadMs = elapsedMs(start);
+
+    vector<const person*> probes;
+    for (size_t q = 0; q < queries; ++q) probes.push_back(&source[rng() % count]);
+
+    // Linear scans, as the ride list did before
+    size_t scanHits = 0;
+    start = chrono::steady_clock::now();
+    for (const person* probe : probes) {
+        for (const person& p : store) {
+            if (p.ride_id == probe->ride_id) { ++scanHits; break; }
+        }
+    }
+    double scanIdUs = elapsedMs(start) * 1000.0 / queries;
+
+    start = chrono::steady_clock::now();
+    for (const person* probe : probes) {
+        string wanted = lowerCopy(probe->fname);
+        for (const person& p : store) {
+            if (lowerCopy(p.fname) == wanted) ++scanHits;
+        }
+    }
+    double scanNameUs = elapsedMs(start) * 1000.0 / queries;
+
+    size_t indexHits = 0;
+    start = chrono::steady_clock::now();
+    for (const person* probe : probes) {
+        if (store.findById(probe->ride_id).valid()) ++indexHits;
+    }
+    double indexIdUs = elapsedMs(start) * 1000.0 / queries;
+
+    start = chrono::steady_clock::now();
+    for (const person* probe : probes) indexHits += store.findByFirstName(probe->fname).size();
+    double indexNameUs = elapsedMs(start) * 1000.0 / queries;
+
+    // Today's pending rides
+    start = chrono::steady_clock::now();
+    size_t scanToday = 0;
+    for (const person& p : store) {
+        if (p.status == RideStatus::Pending && p.rideDay == 15 && p.rideMonth == 6 && p.rideYear == 2025) ++scanToday;
+    }
+    double scanTodayMs = elapsedMs(start);
+    start = chrono::steady_clock::now();
+    size_t indexToday = store.withStatus(RideStatus::Pending, 15, 6, 2025).size();
+    double indexTodayMs = elapsedMs(start);
+
+    cout << "\n=== Ride store: " << count << " rides (loaded in " << fixed << setprecision(0)
+         << loadMs << " ms) ===\n";
+    cout << setw(22) << "Query" << setw(14) << "Scan" << setw(14) << "Index" << setw(10) << "Speedup" << "\n";
+    cout << setprecision(2);
+    cout << setw(22) << "ride id (us)" << setw(14) << scanIdUs << setw(14) << indexIdUs
+         << setw(9) << setprecision(0) << scanIdUs / indexIdUs << "x\n" << setprecision(2);
+    cout << setw(22) << "first name (us)" << setw(14) << scanNameUs << setw(14) << indexNameUs
+         << setw(9) << setprecision(0) << scanNameUs / indexNameUs << "x\n" << setprecision(2);
+    cout << setw(22) << "pending today (ms)" << setw(14) << scanTodayMs << setw(14) << indexTodayMs
+         << setw(9) << setprecision(0) << scanTodayMs / indexTodayMs << "x\n";
+    cout << "Matches: scan " << scanHits << " / index " << indexHits
+         << ", today " << scanToday << " / " << indexToday << "\n";
+}
+
+// The ride record as it was before statuses, vehicles and places were
+// packed: every field a string or a full int
+struct StringRide {
+    string ride_id;
+    int num_of_persons;
+    string fname, lname, phone, pickup, dropoff;
+    int rideDay, rideMonth, rideYear;
+    string vehicle, status;
+    bool isCurrentRide;
+    double totalFare;
+    int assignedDriverId;
+};
+
+static void benchmarkRideRecord() {
+    static const char* STATUS[] = {"Pending", "Confirmed", "OnRide", "Completed", "Canceled"};
+    static const char* PLACES[] = {"Quezon City", "Manila", "Makati", "Pasig", "Taguig", "Caloocan"};
+    const size_t count = 1000000;
+
+    mt19937 rng(13);
+    vector<StringRide> strings(count);
+    vector<person> compact(count);
+    for (size_t i = 0; i < count; ++i) {
+        StringRide& s = strings[i];
+        person& p = compact[i];
+        s.ride_id = p.ride_id = to_string(1700000000 + i / 4) + "_" + to_string(i % 4);
+        s.fname = p.fname = "Juan";
+        s.lname = p.lname = "Dela Cruz";
+        s.phone = p.phone = "09171234567";
+        uint32_t from = rng() % 6, to = (from + 1 + rng() % 5) % 6;
+        s.pickup = PLACES[from];
+        s.dropoff = PLACES[to];
+        p.pickup = from;
+        p.dropoff = to;
+        s.rideDay = 1 + rng() % 28;
+        s.rideMonth = 1 + rng() % 12;
+        s.rideYear = 2025;
+        p.setDate(s.rideDay, s.rideMonth, s.rideYear);
+        uint32_t status = rng() % RIDE_STATUS_COUNT;
+        s.status = STATUS[status];
+        p.status = static_cast<RideStatus>(status);
+        s.vehicle = "Sedan";
+        p.vehicle = VehicleType::Sedan;
+    }
+
+    // Heap bytes for strings too long for the small-string buffer
+    auto heapBytes = [](const string& text) { return text.capacity() > 15 ? text.capacity() + 1 : 0; };
+    size_t stringBytes = 0, compactBytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const StringRide& s = strings[i];
+        const person& p = compact[i];
+        stringBytes += sizeof(StringRide) + heapBytes(s.ride_id) + heapBytes(s.fname) + heapBytes(s.lname) +
+                       heapBytes(s.phone) + heapBytes(s.pickup) + heapBytes(s.dropoff) +
+                       heapBytes(s.vehicle) + heapBytes(s.status);
+        compactBytes += sizeof(person) + heapBytes(p.ride_id) + heapBytes(p.fname) + heapBytes(p.lname) +
+                        heapBytes(p.phone);
+    }
+
+    // The hot checks: pending or confirmed rides today, and completed or
+    // canceled ones, as cancelRides used to test them
+    auto start = chrono::steady_clock::now();
+    size_t stringHits = 0;
+    for (const StringRide& s : strings) {
+        if ((s.status == "Confirmed" || s.status == "Pending") && s.rideDay == 15 && s.rideMonth == 6 && s.rideYear == 2025) ++stringHits;
+        if (lowerCopy(s.status) == "completed" || lowerCopy(s.status) == "canceled") ++stringHits;
+    }
+    double stringMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    size_t compactHits = 0;
+    for (const person& p : compact) {
+        if ((p.status == RideStatus::Confirmed || p.status == RideStatus::Pending) && p.dateKey() == 20250615) ++compactHits;
+        if (p.status == RideStatus::Completed || p.status == RideStatus::Canceled) ++compactHits;
+    }
+    double compactMs = elapsedMs(start);
+
+    cout << "\n=== Ride record: " << count << " rides ===\n";
+    cout << setw(10) << "Layout" << setw(14) << "Record bytes" << setw(14) << "Bytes/ride"
+         << setw(14) << "Checks ms" << "\n";
+    cout << fixed << setprecision(2);
+    cout << setw(10) << "strings" << setw(14) << sizeof(StringRide) << setw(14) << stringBytes / count
+         << setw(14) << stringMs << "\n";
+    cout << setw(10) << "compact" << setw(14) << sizeof(person) << setw(14) << compactBytes / count
+         << setw(14) << compactMs << "\n";
+    cout << "Matches: " << stringHits << " / " << compactHits << "\n";
+}
+
+static person journalRide(size_t i, mt19937& rng, uint32_t places) {
+    person p;
+    p.ride_id = to_string(1700000000 + i / 4) + "_" + to_string(i % 4);
+    p.fname = "Juan";
+    p.lname = "Dela Cruz";
+    p.phone = "09171234567";
+    p.pickup = rng() % places;
+    p.dropoff = rng() % places;
+    p.setDate(1 + rng() % 28, 1 + rng() % 12, 2025);
+    p.totalFare = 150.0;
+    return p;
+}
+
+static void benchmarkJournal() {
+    const uint32_t places = static_cast<uint32_t>(max<size_t>(CityCatalog::instance().size(), 1));
+    const size_t count = 1000000;
+    const filesystem::path dir = filesystem::temp_directory_path() / "ride_app_benchmark_journal";
+    filesystem::remove_all(dir);
+    filesystem::create_directories(dir);
+    const string base = (dir / "rides").string();
+    mt19937 rng(21);
+
+    cout << "\n=== Ride journal ===\n";
+    cout << fixed << setprecision(0);
+
+    // Bookings and edits through the store, one wait at the end
+    {
+        RideStore store;
+        store.reserve(count);
+        RideJournal journal;
+        journal.open(base, store);
+        store.attach(&journal);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            RideHandle handle = store.add(journalRide(i, rng, places));
+            if (i % 4 == 3) store.update(handle, [](person& ride) { ride.status = RideStatus::Confirmed; });
+            if (i % 16 == 15) store.erase(handle);
+        }
+        journal.waitDurable();
+        double ms = elapsedMs(start);
+        cout << "Group commit: " << journal.appendedCount() << " records, " << journal.syncCount()
+             << " syncs, " << journal.appendedCount() / (ms / 1000.0) << " records/s\n";
+
+        // One booking desk that waits for every record, and eight sharing syncs
+        const size_t waited = 300;
+        start = chrono::steady_clock::now();
+        uint64_t syncsBefore = journal.syncCount();
+        for (size_t i = 0; i < waited; ++i) {
+            journal.waitDurable(journal.recordPut(RideHandle{0, 0}, journalRide(i, rng, places)));
+        }
+        ms = elapsedMs(start);
+        cout << "Sync per record: " << waited << " records, " << journal.syncCount() - syncsBefore
+             << " syncs, " << waited / (ms / 1000.0) << " records/s\n";
+
+        const size_t desks = 8;
+        start = chrono::steady_clock::now();
+        syncsBefore = journal.syncCount();
+        vector<thread> workers;
+        for (size_t d = 0; d < desks; ++d) {
+            workers.emplace_back([&journal, d, places, waited] {
+                mt19937 local(static_cast<unsigned>(d));
+                for (size_t i = 0; i < waited; ++i) {
+                    journal.waitDurable(journal.recordPut(RideHandle{0, 0}, journalRide(i, local, places)));
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        ms = elapsedMs(start);
+        cout << desks << " desks, each waiting: " << desks * waited << " records, "
+             << journal.syncCount() - syncsBefore << " syncs, " << desks * waited / (ms / 1000.0) << " records/s\n";
+        // Fold everything so far into the snapshot, as the background thread does
+        start = chrono::steady_clock::now();
+        journal.checkpoint();
+        ms = elapsedMs(start);
+        cout << "Checkpoint: " << store.size() << " rides in " << ms << " ms, snapshot "
+             << filesystem::file_size(base + ".snapshot") / (1024 * 1024) << " MB\n";
+        journal.close();
+    }
+
+    // Startup: the snapshot alone, then the snapshot and a tail of records after it
+    const size_t tail = 100000;
+    double snapshotMs = 0;
+    for (int round = 0; round < 2; ++round) {
+        RideStore store;
+        RideJournal journal;
+        auto start = chrono::steady_clock::now();
+        journal.open(base, store);
+        double ms = elapsedMs(start);
+        if (round == 0) {
+            snapshotMs = ms;
+            cout << "Startup from snapshot: " << journal.restoredCount() << " rides in " << ms << " ms\n";
+            store.attach(&journal);
+            for (size_t i = 0; i < tail; ++i) store.add(journalRide(i, rng, places));
+            journal.waitDurable();
+        } else {
+            cout << "Startup with a tail: " << journal.restoredCount() << " rides + " << journal.replayedCount()
+                 << " records in " << ms << " ms (" << ms - snapshotMs << " ms for the tail)\n";
+        }
+        journal.close();
+    }
+    filesystem::remove_all(dir);
+}
+
+// A scripted mix of bookings, edits, cancels, deletes, lookups and
+// searches through the headless command mode
+static void benchmarkCommandMode() {
+    const vector<City>& places = CityCatalog::instance().cities();
+    if (places.size() < 2) return;
+    const size_t count = 200000;
+    const char* vehicles[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus"};
+    mt19937 rng(31);
+
+    string script;
+    vector<size_t> booked;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned pick = rng() % 100;
+        string id = "R" + to_string(booked.empty() ? 0 : booked[rng() % booked.size()]);
+        if (pick < 50 || booked.empty()) {
+            size_t from = rng() % places.size(), to = (from + 1 + rng() % (places.size() - 1)) % places.size();
+            script += "book,First" + to_string(rng() % 1000) + ",Last" + to_string(rng() % 1000) + ",0917" +
+                      to_string(1000000 + rng() % 9000000) + "," + string(places[from].name) + "," +
+                      string(places[to].name) + "," + vehicles[rng() % 6] + ",2026-10-" + to_string(10 + rng() % 18) +
+                      ",1,R" + to_string(i) + "\n";
+            booked.push_back(i);
+        } else if (pick < 70) {
+            script += "edit," + id + ",phone,0918" + to_string(1000000 + rng() % 9000000) + "\n";
+        } else if (pick < 78) {
+            script += "cancel," + id + "\n";
+        } else if (pick < 83) {
+            script += "delete," + id + "\n";
+        } else if (pick < 95) {
+            script += "view," + id + "\n";
+        } else {
+            script += "search,First" + to_string(rng() % 1000) + ",Last" + to_string(rng() % 1000) + "\n";
+        }
+    }
+
+    cout << "\n=== Headless command mode ===\n";
+    cout << fixed << setprecision(0);
+    const filesystem::path dir = filesystem::temp_directory_path() / "ride_app_benchmark_commands";
+    for (int journaled = 0; journaled < 2; ++journaled) {
+        DriverManager drivers;
+        for (int id = 0; id < 20000; ++id) {
+            drivers.addDriver(id, "Driver", "0917", vehicles[id % 6]);
+            const City& spot = places[(id * 2654435761u) % places.size()];
+            drivers.updateLocation(id, spot.lat, spot.lon);
+        }
+        RideStore store;
+        RideJournal journal;
+        if (journaled) {
+            filesystem::remove_all(dir);
+            filesystem::create_directories(dir);
+            journal.open((dir / "rides").string(), store);
+            store.attach(&journal);
+        }
+        RideService service(store, drivers);
+        CommandMode commands(service, journaled ? &journal : nullptr);
+
+        istringstream in(script);
+        ostringstream out;
+        auto start = chrono::steady_clock::now();
+        size_t failed = commands.run(in, out);
+        double ms = elapsedMs(start);
+        cout << (journaled ? "Journaled: " : "In memory: ") << commands.commandCount() << " commands ("
+             << failed << " refused) in " << ms << " ms, " << commands.commandCount() / (ms / 1000.0)
+             << " per second\n";
+        journal.close();
+    }
+    filesystem::remove_all(dir);
+}
+
+int main() {
+    benchmarkDistances();
+    benchmarkTransit();
+    benchmarkRailFares();
+    benchmarkDispatch();
+    benchmarkRosterLoad();
+    benchmarkNearestDispatch();
+    benchmarkBatchDispatch();
+    benchmarkRideStore();
+    benchmarkRideRecord();
+    benchmarkJournal();
+    benchmarkCommandMode();
+    return 0;
+}
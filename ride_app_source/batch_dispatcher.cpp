@@ -0,0 +1,240 @@
+#include "batch_dispatcher.h"
+#include "distance_calculator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+static constexpr double INF = numeric_limits<double>::infinity();
+
+// One vehicle type's share of the batch
+struct Group {
+    vector<size_t> requests;        // indexes into the batch
+    vector<const Driver*> candidates;
+    vector<double> cost;            // requests x candidates, km
+    vector<int> choice;             // per request, candidate index or -1
+    vector<int> greedyChoice;
+    bool exact = true;              // small enough for the Hungarian solver
+};
+
+// Run task(0) .. task(count - 1) on threads of their own, or inline when
+// there is only one
+template <typename Task>
+static void runTasks(size_t count, const Task& task) {
+    if (count <= 1) {
+        if (count == 1) task(0);
+        return;
+    }
+    vector<thread> workers;
+    for (size_t t = 0; t < count; ++t) workers.emplace_back(task, t);
+    for (auto& worker : workers) worker.join();
+}
+
+// Minimum-cost assignment of every row to a distinct column of a rows x
+// cols matrix (rows <= cols), by shortest augmenting paths with
+// potentials. O(rows^2 * cols). Returns the column of each row.
+static vector<int> hungarian(const vector<double>& cost, size_t rows, size_t cols) {
+    vector<double> u(rows + 1, 0), v(cols + 1, 0), minv(cols + 1);
+    vector<size_t> match(cols + 1, 0), way(cols + 1, 0);
+    vector<char> used(cols + 1);
+
+    for (size_t i = 1; i <= rows; ++i) {
+        match[0] = i;
+        size_t j0 = 0;
+        fill(minv.begin(), minv.end(), INF);
+        fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = 1;
+            size_t i0 = match[j0], j1 = 0;
+            double delta = INF;
+            const double* row = &cost[(i0 - 1) * cols];
+            for (size_t j = 1; j <= cols; ++j) {
+                if (used[j]) continue;
+                double reduced = row[j - 1] - u[i0] - v[j];
+                if (reduced < minv[j]) {
+                    minv[j] = reduced;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (size_t j = 0; j <= cols; ++j) {
+                if (used[j]) {
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (match[j0] != 0);
+
+        // Flip the augmenting path
+        do {
+            size_t j1 = way[j0];
+            match[j0] = match[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    vector<int> result(rows, -1);
+    for (size_t j = 1; j <= cols; ++j) {
+        if (match[j] != 0) result[match[j] - 1] = static_cast<int>(j - 1);
+    }
+    return result;
+}
+
+// Each request in turn takes its closest unused candidate
+static vector<int> greedy(const vector<double>& cost, size_t rows, size_t cols) {
+    vector<int> result(rows, -1);
+    vector<char> taken(cols, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        const double* row = &cost[i * cols];
+        double best = INF;
+        for (size_t j = 0; j < cols; ++j) {
+            if (!taken[j] && row[j] < best) {
+                best = row[j];
+                result[i] = static_cast<int>(j);
+            }
+        }
+        if (result[i] >= 0) taken[result[i]] = 1;
+    }
+    return result;
+}
+
+static void solve(Group& group) {
+    size_t rows = group.requests.size(), cols = group.candidates.size();
+    group.greedyChoice = greedy(group.cost, rows, cols);
+
+    if (rows <= cols) {
+        group.choice = hungarian(group.cost, rows, cols);
+        return;
+    }
+
+    // More requests than drivers: give every driver a request instead
+    vector<double> flipped(rows * cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) flipped[j * rows + i] = group.cost[i * cols + j];
+    }
+    vector<int> requestOf = hungarian(flipped, cols, rows);
+    group.choice.assign(rows, -1);
+    for (size_t j = 0; j < cols; ++j) group.choice[requestOf[j]] = static_cast<int>(j);
+}
+
+BatchDispatcher::Result BatchDispatcher::dispatch(const vector<Request>& requests) {
+    auto start = chrono::steady_clock::now();
+    Result result;
+    result.driverIds.assign(requests.size(), -1);
+    result.pickupKm.assign(requests.size(), -1);
+
+    vector<Group> groups;
+    unordered_map<string_view, size_t> groupOf;
+    for (size_t r = 0; r < requests.size(); ++r) {
+        auto [it, added] = groupOf.emplace(requests[r].vehicle, groups.size());
+        if (added) groups.emplace_back();
+        groups[it->second].requests.push_back(r);
+    }
+
+    // Candidates: the free drivers near each request. Clustered requests
+    // share neighbours, so widen the search until there are enough.
+    for (auto& group : groups) {
+        group.exact = group.requests.size() <= MAX_EXACT_REQUESTS;
+        if (!group.exact) continue;
+        string_view vehicle = requests[group.requests.front()].vehicle;
+        size_t wanted = min(drivers.availableCount(vehicle), 2 * group.requests.size());
+        for (size_t k = CANDIDATES_PER_REQUEST; ; k *= 2) {
+            unordered_set<const Driver*> seen;
+            group.candidates.clear();
+            for (size_t r : group.requests) {
+                for (const Driver* driver : drivers.nearestFreeDrivers(vehicle, requests[r].lat, requests[r].lon, k)) {
+                    if (seen.insert(driver).second) group.candidates.push_back(driver);
+                }
+            }
+            if (group.candidates.size() >= wanted || k >= wanted) break;
+        }
+    }
+
+    // Cost matrices, rows dealt out round-robin over every group
+    vector<pair<Group*, size_t>> rows;
+    size_t costs = 0;
+    for (auto& group : groups) {
+        if (!group.exact) continue;
+        group.cost.resize(group.requests.size() * group.candidates.size());
+        costs += group.cost.size();
+        for (size_t i = 0; i < group.requests.size(); ++i) rows.push_back({&group, i});
+    }
+
+    size_t threadCount = (costs < MIN_PARALLEL_COSTS) ? 1 : max(1u, thread::hardware_concurrency());
+    runTasks(threadCount, [&](size_t t) {
+        for (size_t n = t; n < rows.size(); n += threadCount) {
+            Group& group = *rows[n].first;
+            size_t i = rows[n].second;
+            const Request& request = requests[group.requests[i]];
+            double* out = &group.cost[i * group.candidates.size()];
+            for (size_t j = 0; j < group.candidates.size(); ++j) {
+                const Driver& driver = *group.candidates[j];
+                out[j] = haversineKm(driver.lat, driver.lon, request.lat, request.lon);
+            }
+        }
+    });
+
+    // Solve the vehicle types in parallel, biggest first
+    vector<Group*> order;
+    for (auto& group : groups) {
+        if (group.exact) order.push_back(&group);
+    }
+    sort(order.begin(), order.end(), [](const Group* a, const Group* b) {
+        return a->requests.size() > b->requests.size();
+    });
+    atomic<size_t> next(0);
+    runTasks(min(threadCount, order.size()), [&](size_t) {
+        for (size_t g = next++; g < order.size(); g = next++) solve(*order[g]);
+    });
+
+    for (const auto& group : groups) {
+        if (!group.exact) {
+            // Too big to solve exactly: nearest free driver, request by request
+            result.exact = false;
+            for (size_t r : group.requests) {
+                double km;
+                Driver* driver = drivers.assignNearestDriver(requests[r].vehicle, requests[r].lat, requests[r].lon, &km);
+                if (!driver) continue;
+                result.driverIds[r] = driver->id;
+                result.pickupKm[r] = max(km, 0.0);
+                result.matched++;
+                result.totalKm += result.pickupKm[r];
+                result.greedyMatched++;
+                result.greedyKm += result.pickupKm[r];
+            }
+            continue;
+        }
+
+        size_t cols = group.candidates.size();
+        for (size_t i = 0; i < group.requests.size(); ++i) {
+            if (group.greedyChoice[i] >= 0) {
+                result.greedyMatched++;
+                result.greedyKm += group.cost[i * cols + group.greedyChoice[i]];
+            }
+            if (group.choice[i] < 0) continue;
+
+            Driver* driver = drivers.claimDriver(group.candidates[group.choice[i]]->id);
+            if (!driver) continue;
+            size_t r = group.requests[i];
+            result.driverIds[r] = driver->id;
+            result.pickupKm[r] = group.cost[i * cols + group.choice[i]];
+            result.matched++;
+            result.totalKm += result.pickupKm[r];
+        }
+    }
+
+    result.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,51 @@
+#ifndef BATCH_DISPATCHER_H
+#define BATCH_DISPATCHER_H
+
+#include "driver_manager.h"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Assigns a whole batch of waiting rides to free drivers at once, keeping
+// the total pickup distance as small as possible. Each vehicle type is a
+// separate assignment problem over the requests and the free drivers near
+// them, solved exactly with the Hungarian algorithm; very large batches
+// fall back to greedy nearest-driver matching. Cost matrices and vehicle
+// types are worked on in parallel.
+class BatchDispatcher {
+public:
+    struct Request {
+        std::string_view vehicle;
+        double lat, lon;
+    };
+
+    struct Result {
+        std::vector<int> driverIds;     // per request, -1 if unmatched
+        std::vector<double> pickupKm;   // per request, -1 if unmatched
+        size_t matched = 0;
+        double totalKm = 0;             // sum of pickupKm over matches
+        // The same requests matched greedily, in order, for comparison
+        size_t greedyMatched = 0;
+        double greedyKm = 0;
+        bool exact = true;              // false if any type fell back to greedy
+        double milliseconds = 0;
+    };
+
+    // Nearby free drivers considered per request (more if they run short)
+    static constexpr size_t CANDIDATES_PER_REQUEST = 8;
+    // Larger groups of one vehicle type use greedy matching
+    static constexpr size_t MAX_EXACT_REQUESTS = 400;
+    // Batches with fewer request x driver costs than this are worked out
+    // on the calling thread; starting threads would cost more
+    static constexpr size_t MIN_PARALLEL_COSTS = 1 << 15;
+
+    explicit BatchDispatcher(DriverManager& drivers) : drivers(drivers) {}
+
+    // Match the requests and claim the chosen drivers
+    Result dispatch(const std::vector<Request>& requests);
+
+private:
+    DriverManager& drivers;
+};
+
+#endif // BATCH_DISPATCHER_H
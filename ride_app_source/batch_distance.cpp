@@ -0,0 +1,121 @@
+#include "batch_distance.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// With per-point sines and cosines, the haversine of the central angle is
+//   hav = (1 - (sinLat1 sinLat2 + cosLat1 cosLat2 cos(lon1 - lon2))) / 2
+//   cos(lon1 - lon2) = cosLon1 cosLon2 + sinLon1 sinLon2
+// which is only multiplies and adds, and distance = 2R asin(sqrt(hav)).
+static constexpr double EARTH_DIAMETER_KM = 2 * 6371.0;
+static constexpr double PI_DIV_180 = M_PI / 180.0;
+
+void GeoPoints::add(double lat, double lon) {
+    double phi = lat * PI_DIV_180;
+    double lambda = lon * PI_DIV_180;
+    sinLat.push_back(sin(phi));
+    cosLat.push_back(cos(phi));
+    sinLon.push_back(sin(lambda));
+    cosLon.push_back(cos(lambda));
+}
+
+void GeoPoints::reserve(size_t count) {
+    sinLat.reserve(count);
+    cosLat.reserve(count);
+    sinLon.reserve(count);
+    cosLon.reserve(count);
+}
+
+GeoPoints GeoPoints::fromCities(const vector<City>& cities) {
+    GeoPoints points;
+    points.reserve(cities.size());
+    for (const auto& city : cities) {
+        points.add(city.lat, city.lon);
+    }
+    return points;
+}
+
+static inline double scalarDistance(double sinA, double cosA, double sinL, double cosL,
+                                    const GeoPoints& points, size_t j) {
+    double cosDlon = cosL * points.cosLon[j] + sinL * points.sinLon[j];
+    double cosAngle = sinA * points.sinLat[j] + cosA * points.cosLat[j] * cosDlon;
+    double hav = min(1.0, max(0.0, (1.0 - cosAngle) * 0.5));
+    return EARTH_DIAMETER_KM * asin(sqrt(hav));
+}
+
+#ifdef __AVX2__
+// asin(x) = pi/2 - sqrt(1 - x) * P(x) for 0 <= x <= 1, |error| <= 2e-8
+// (Abramowitz & Stegun 4.4.46); about 0.25 m after scaling by 2R
+static inline __m256d asinUnit(__m256d x) {
+    const __m256d c7 = _mm256_set1_pd(-0.0012624911);
+    __m256d p = _mm256_add_pd(_mm256_mul_pd(c7, x), _mm256_set1_pd(0.0066700901));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(-0.0170881256));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(0.0308918810));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(-0.0501743046));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(0.0889789874));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(-0.2145988016));
+    p = _mm256_add_pd(_mm256_mul_pd(p, x), _mm256_set1_pd(1.5707963050));
+    __m256d root = _mm256_sqrt_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), x));
+    return _mm256_sub_pd(_mm256_set1_pd(M_PI / 2), _mm256_mul_pd(root, p));
+}
+#endif
+
+// Distances to points[first..] written to out[0..]
+static void distancesFromTrig(const GeoPoints& points, double sinA, double cosA,
+                              double sinL, double cosL, double* out, size_t first = 0) {
+    size_t n = points.size();
+    size_t j = first;
+
+#ifdef __AVX2__
+    const __m256d vSinA = _mm256_set1_pd(sinA), vCosA = _mm256_set1_pd(cosA);
+    const __m256d vSinL = _mm256_set1_pd(sinL), vCosL = _mm256_set1_pd(cosL);
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5), diameter = _mm256_set1_pd(EARTH_DIAMETER_KM);
+
+    for (; j + 4 <= n; j += 4) {
+        __m256d cosDlon = _mm256_add_pd(_mm256_mul_pd(vCosL, _mm256_loadu_pd(&points.cosLon[j])),
+                                        _mm256_mul_pd(vSinL, _mm256_loadu_pd(&points.sinLon[j])));
+        __m256d cosAngle = _mm256_add_pd(
+            _mm256_mul_pd(vSinA, _mm256_loadu_pd(&points.sinLat[j])),
+            _mm256_mul_pd(_mm256_mul_pd(vCosA, _mm256_loadu_pd(&points.cosLat[j])), cosDlon));
+        __m256d hav = _mm256_mul_pd(_mm256_sub_pd(one, cosAngle), half);
+        hav = _mm256_min_pd(one, _mm256_max_pd(zero, hav));
+        _mm256_storeu_pd(out + (j - first), _mm256_mul_pd(diameter, asinUnit(_mm256_sqrt_pd(hav))));
+    }
+#endif
+
+    for (; j < n; ++j) {
+        out[j - first] = scalarDistance(sinA, cosA, sinL, cosL, points, j);
+    }
+}
+
+void distancesFrom(const GeoPoints& points, double lat, double lon, double* out) {
+    double phi = lat * PI_DIV_180;
+    double lambda = lon * PI_DIV_180;
+    distancesFromTrig(points, sin(phi), cos(phi), sin(lambda), cos(lambda), out);
+}
+
+void distancesFrom(const GeoPoints& points, size_t index, double* out, size_t first) {
+    distancesFromTrig(points, points.sinLat[index], points.cosLat[index],
+                      points.sinLon[index], points.cosLon[index], out, first);
+}
+
+void distanceMatrix(const GeoPoints& from, const GeoPoints& to, double* out) {
+    for (size_t i = 0; i < from.size(); ++i) {
+        distancesFromTrig(to, from.sinLat[i], from.cosLat[i],
+                          from.sinLon[i], from.cosLon[i], out + i * to.size());
+    }
+}
+
+bool batchDistanceVectorized() {
+#ifdef __AVX2__
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,36 @@
+#ifndef BATCH_DISTANCE_H
+#define BATCH_DISTANCE_H
+
+#include "distance_calculator.h"
+#include <vector>
+
+// Coordinates of many places in struct-of-arrays form, with the sines and
+// cosines each distance needs computed once per point instead of per pair.
+struct GeoPoints {
+    std::vector<double> sinLat, cosLat;
+    std::vector<double> sinLon, cosLon;
+
+    void add(double lat, double lon);
+    void reserve(size_t count);
+    size_t size() const { return sinLat.size(); }
+
+    static GeoPoints fromCities(const std::vector<City>& cities);
+};
+
+// Great-circle distance in km from one coordinate to every point.
+// out must hold points.size() values.
+void distancesFrom(const GeoPoints& points, double lat, double lon, double* out);
+
+// Same, from points[index] to points[first..]. out must hold
+// points.size() - first values.
+void distancesFrom(const GeoPoints& points, size_t index, double* out, size_t first = 0);
+
+// Distance from every point in `from` to every point in `to`, row-major:
+// out[i * to.size() + j]. out must hold from.size() * to.size() values.
+void distanceMatrix(const GeoPoints& from, const GeoPoints& to, double* out);
+
+// True when the kernels were compiled with AVX2 (build with -mavx2 or /arch:AVX2).
+// Either way results agree with calculateDistance() to within a metre.
+bool batchDistanceVectorized();
+
+#endif // BATCH_DISTANCE_H
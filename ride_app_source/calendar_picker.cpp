@@ -3,9 +3,57 @@
 #include <string>
 #include <ctime>
 #include <cstdlib>
-#include <conio.h> // For _getch() on Windows, may need to change for other platforms
 #include "calendar_picker.h"
 
+#ifdef _WIN32
+#include <conio.h>
+
+static int readKey() {
+    return _getch();
+}
+#else
+#include <cstdio>
+#include <termios.h>
+#include <unistd.h>
+
+// One key press without waiting for Enter, in _getch() terms: arrow keys
+// come back as 224 and then 72/80/75/77, Enter as 13
+static int readKey() {
+    static int pending = -1;
+    if (pending != -1) {
+        int key = pending;
+        pending = -1;
+        return key;
+    }
+
+    termios saved;
+    bool raw = tcgetattr(STDIN_FILENO, &saved) == 0;
+    if (raw) {
+        termios keys = saved;
+        keys.c_lflag &= ~(ICANON | ECHO);
+        keys.c_cc[VMIN] = 1;
+        keys.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &keys);
+    }
+
+    int key = getchar();
+    if (key == 27 && getchar() == '[') {    // ESC [ A..D
+        switch (getchar()) {
+            case 'A': pending = 72; break;
+            case 'B': pending = 80; break;
+            case 'D': pending = 75; break;
+            case 'C': pending = 77; break;
+        }
+        if (pending != -1) key = 224;
+    }
+    if (raw) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+
+    // No more input: take the date shown rather than loop
+    if (key == '\n' || key == EOF) key = 13;
+    return key;
+}
+#endif
+
 
 // Function to check if a year is a leap year
 bool isLeapYear(int year) {
@@ -98,11 +146,11 @@ void selectDate(int &month, int &year, int &day) {
         std::cout << "\nUse arrow keys to navigate, Enter to select, Q to quit";
         std::cout << "\nSelected date: " << year << "-" << month << "-" << day << "\n";
         
-        key = _getch();
+        key = static_cast<char>(readKey());
         
-        // Handle arrow keys (Windows specific, may need adjustment for other platforms)
+        // Handle arrow keys
         if (key == 0 || key == -32) { // Arrow key prefix
-            key = _getch();
+            key = static_cast<char>(readKey());
             switch (key) {
                 case 72: // Up arrow
                     day -= 7;
@@ -3,4 +3,8 @@
 
 void selectDate(int &month, int &year, int &day);
 
+bool isLeapYear(int year);
+// 0 for a month outside 1..12
+int daysInMonth(int month, int year);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include "city_catalog.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char SNAPSHOT_MAGIC[4] = {'G', 'R', 'C', 'T'};
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+static const char* SNAPSHOT_FILE = "city_catalog.bin";
+
+// Snapshot layout, every section 8-byte aligned:
+//   header | name offsets (count + 1) | name pool | latitudes | longitudes
+//   | sources | name index slots
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t indexSlots;
+    uint64_t fingerprint;
+    uint64_t poolBytes;
+    uint64_t nameOffsetsAt;
+    uint64_t poolAt;
+    uint64_t latAt;
+    uint64_t lonAt;
+    uint64_t sourceAt;
+    uint64_t indexAt;
+    uint64_t totalBytes;
+};
+
+static inline uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+// 64-bit FNV-1a, folded over the bytes of each value
+static void fingerprintBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+// Look for a data file next to the executable or in a Data_Csv folder
+static bool findDataFile(const string& file, fs::path& found) {
+    vector<fs::path> possible_paths = {
+        fs::current_path() / "Data_Csv" / file,
+        fs::current_path().parent_path() / "Data_Csv" / file,
+        fs::current_path() / file,
+        fs::current_path().parent_path() / file
+    };
+
+    for (const auto& path : possible_paths) {
+        if (fs::exists(path)) {
+            found = path;
+            return true;
+        }
+    }
+    return false;
+}
+
+const CityCatalog& CityCatalog::instance() {
+    // Initialized once, thread-safe since C++11
+    static const CityCatalog catalog;
+    return catalog;
+}
+
+CityCatalog::CityCatalog() : CityCatalog(string()) {}
+
+CityCatalog::CityCatalog(const string& directory) {
+    locateSources(directory);
+    if (!loadSnapshot(snapshotPath())) {
+        loadAllCities();
+    }
+}
+
+const City* CityCatalog::find(const string& name) const {
+    // Normalized keys are unique, so an exact match must be the keyed entry
+    const City* city = findNormalized(name);
+    return (city && city->name == name) ? city : nullptr;
+}
+
+const City* CityCatalog::findNormalized(const string& name) const {
+    uint32_t id = byKey.find(name, entries);
+    return (id != NameIndex::NOT_FOUND) ? &entries[id] : nullptr;
+}
+
+const FuzzyMatcher& CityCatalog::fuzzy() const {
+    call_once(fuzzyBuilt, [this] { fuzzyMatcher.reset(new FuzzyMatcher(entries)); });
+    return *fuzzyMatcher;
+}
+
+vector<const City*> CityCatalog::complete(const string& prefix, size_t k) const {
+    call_once(prefixBuilt, [this] { prefixIndex.reset(new PrefixIndex(entries)); });
+    return prefixIndex->complete(prefix, k);
+}
+
+const SpatialIndex& CityCatalog::spatial() const {
+    call_once(spatialBuilt, [this] { spatialIndex.reset(new SpatialIndex(entries)); });
+    return *spatialIndex;
+}
+
+string CityCatalog::snapshotPath() const {
+    return (fs::path(dataDir) / SNAPSHOT_FILE).string();
+}
+
+void CityCatalog::locateSources(const string& directory) {
+    sources = {
+        {"Cities.csv", CitySource::Cities, ""}, {"Ejeep.csv", CitySource::Ejeep, ""},
+        {"LRT-2.csv", CitySource::LRT2, ""}, {"LRT.csv", CitySource::LRT, ""},
+        {"Major_Bus.csv", CitySource::MajorBus, ""}, {"MRT-3.csv", CitySource::MRT3, ""},
+        {"PNR.csv", CitySource::PNR, ""}
+    };
+
+    fingerprint = 14695981039346656037ull;
+    for (auto& source : sources) {
+        fs::path csv_path;
+        bool found;
+        if (directory.empty()) {
+            found = findDataFile(source.file, csv_path);
+        } else {
+            csv_path = fs::path(directory) / source.file;
+            found = fs::exists(csv_path);
+        }
+        if (found) {
+            source.path = csv_path.string();
+            if (dataDir.empty()) dataDir = csv_path.parent_path().string();
+        }
+
+        // Name, size and modification time of every file, found or not
+        error_code ec;
+        uint64_t size = found ? static_cast<uint64_t>(fs::file_size(csv_path, ec)) : 0;
+        int64_t modified = found ? static_cast<int64_t>(fs::last_write_time(csv_path, ec).time_since_epoch().count()) : 0;
+        fingerprintBytes(fingerprint, source.file.data(), source.file.size());
+        fingerprintBytes(fingerprint, &size, sizeof(size));
+        fingerprintBytes(fingerprint, &modified, sizeof(modified));
+    }
+}
+
+bool CityCatalog::loadSnapshot(const string& path) {
+    if (dataDir.empty() || !snapshot.open(path)) return false;
+
+    SnapshotHeader header;
+    if (snapshot.size() < sizeof(header)) {
+        snapshot.close();
+        return false;
+    }
+    memcpy(&header, snapshot.data(), sizeof(header));
+
+    // Stale or foreign files fall back to the CSVs
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SNAPSHOT_VERSION ||
+        header.fingerprint != fingerprint || header.totalBytes != snapshot.size()) {
+        snapshot.close();
+        return false;
+    }
+
+    const char* base = snapshot.data();
+    const uint32_t* nameOffsets = reinterpret_cast<const uint32_t*>(base + header.nameOffsetsAt);
+    const char* pool = base + header.poolAt;
+    const double* lat = reinterpret_cast<const double*>(base + header.latAt);
+    const double* lon = reinterpret_cast<const double*>(base + header.lonAt);
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(base + header.sourceAt);
+
+    // Names and the index are used in place; only the City records are built
+    entries.reserve(header.count);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        string_view name(pool + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+        entries.push_back({name, lat[i], lon[i], static_cast<CitySource>(source[i])});
+    }
+    byKey.borrow(reinterpret_cast<const NameIndex::Slot*>(base + header.indexAt),
+                 header.indexSlots, header.count);
+    return true;
+}
+
+bool CityCatalog::saveSnapshot(const string& path) const {
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.count = static_cast<uint32_t>(entries.size());
+    header.fingerprint = fingerprint;
+
+    vector<uint32_t> nameOffsets;
+    nameOffsets.reserve(entries.size() + 1);
+    uint64_t poolBytes = 0;
+    for (const auto& city : entries) {
+        nameOffsets.push_back(static_cast<uint32_t>(poolBytes));
+        poolBytes += city.name.size();
+    }
+    nameOffsets.push_back(static_cast<uint32_t>(poolBytes));
+    header.poolBytes = poolBytes;
+
+    header.indexSlots = static_cast<uint32_t>(byKey.tableSize());
+
+    header.nameOffsetsAt = align8(sizeof(header));
+    header.poolAt = align8(header.nameOffsetsAt + nameOffsets.size() * sizeof(uint32_t));
+    header.latAt = align8(header.poolAt + poolBytes);
+    header.lonAt = header.latAt + entries.size() * sizeof(double);
+    header.sourceAt = header.lonAt + entries.size() * sizeof(double);
+    header.indexAt = align8(header.sourceAt + entries.size());
+    header.totalBytes = header.indexAt + byKey.tableSize() * sizeof(NameIndex::Slot);
+
+    // Write beside the target and rename, so readers never see half a file
+    string temp = path + ".tmp";
+    {
+        ofstream out(temp, ios::binary | ios::trunc);
+        if (!out) return false;
+
+        auto padTo = [&out](uint64_t offset) {
+            static const char zeros[8] = {};
+            uint64_t at = static_cast<uint64_t>(out.tellp());
+            out.write(zeros, offset - at);
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        padTo(header.nameOffsetsAt);
+        out.write(reinterpret_cast<const char*>(nameOffsets.data()), nameOffsets.size() * sizeof(uint32_t));
+        padTo(header.poolAt);
+        for (const auto& city : entries) out.write(city.name.data(), city.name.size());
+        padTo(header.latAt);
+        for (const auto& city : entries) out.write(reinterpret_cast<const char*>(&city.lat), sizeof(double));
+        for (const auto& city : entries) out.write(reinterpret_cast<const char*>(&city.lon), sizeof(double));
+        for (const auto& city : entries) out.put(static_cast<char>(city.source));
+        padTo(header.indexAt);
+        out.write(reinterpret_cast<const char*>(byKey.tableData()), byKey.tableSize() * sizeof(NameIndex::Slot));
+        if (!out) return false;
+    }
+
+    error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+void CityCatalog::loadAllCities() {
+    for (const auto& source : sources) {
+        const string& file = source.file;
+        if (source.path.empty()) {
+            cerr << "Warning: File not found in any searched location - " << file << endl;
+            continue;
+        }
+
+        unique_ptr<CsvReader> reader(new CsvReader());
+        if (!reader->open(source.path)) {
+            cerr << "Error: Could not open " << fs::path(source.path) << endl;
+            continue;
+        }
+        entries.reserve(entries.size() + reader->estimateRows(24));
+        byKey.reserve(entries.capacity());
+
+        // Rows look like  "Manila, 14.5995, 120.9842"  (often quoted whole)
+        string_view line;
+        string_view fields[3];
+        while (reader->nextLine(line)) {
+            int line_num = reader->lineNumber();
+            if (line_num == 1) continue;
+
+            size_t count = CsvReader::splitFields(line, fields, 3);
+            if (count < 3 || fields[0].empty() || fields[1].empty() || fields[2].empty()) {
+                cerr << "Warning: Incomplete data in " << file << " at line " << line_num << endl;
+                continue;
+            }
+
+            double lat, lon;
+            if (!parseDouble(fields[1], lat) || !parseDouble(fields[2], lon)) {
+                cerr << "Error parsing line " << line_num << " in " << file << ": invalid number" << endl;
+                cerr << "Problematic line: " << line << endl;
+                continue;
+            }
+
+            // Check for duplicates using normalized name. The name stays a
+            // view into the mapped file, which the catalog keeps open.
+            entries.push_back({ fields[0], lat, lon, source.source });
+            uint32_t id = static_cast<uint32_t>(entries.size() - 1);
+            uint32_t existing = byKey.insert(id, entries);
+            if (existing != id) {
+                cerr << "Warning: Duplicate city found - " << fields[0]
+                     << " (similar to " << entries[existing].name << ") in " << file << endl;
+                entries.pop_back();
+            }
+        }
+        csvFiles.push_back(move(reader));
+    }
+}
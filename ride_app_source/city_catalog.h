@@ -0,0 +1,115 @@
+#ifndef CITY_CATALOG_H
+#define CITY_CATALOG_H
+
+#include "distance_calculator.h"
+#include "name_index.h"
+#include "fuzzy_matcher.h"
+#include "prefix_index.h"
+#include "spatial_index.h"
+#include "csv_reader.h"
+#include "mapped_file.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Every place from the Data_Csv files, loaded once per process and
+// read-only afterwards. Booking, fare and lookup code all share it.
+//
+// Loading maps Data_Csv/city_catalog.bin, a snapshot written by
+// tools/build_catalog_snapshot.cpp, and only parses the CSVs when the
+// snapshot is missing or older than them. City names point into whichever
+// file was mapped, so they live as long as the catalog.
+class CityCatalog {
+public:
+    // The shared catalog (loaded from the CSV files on first use)
+    static const CityCatalog& instance();
+
+    // A catalog of its own from the CSV files in one folder, for tools
+    // and benchmarks working on generated data. Uses the folder's
+    // snapshot when it is up to date.
+    explicit CityCatalog(const std::string& directory);
+
+    // Find a city by its exact name, nullptr if missing
+    const City* find(const std::string& name) const;
+
+    // Find a city whose normalized name matches, nullptr if missing
+    const City* findNormalized(const std::string& name) const;
+
+    // Typo-tolerant matcher over all names (built on first use)
+    const FuzzyMatcher& fuzzy() const;
+
+    // Up to k cities whose name, or a word in it, starts with prefix.
+    // Front desk tools can call this directly as the user types.
+    std::vector<const City*> complete(const std::string& prefix, size_t k) const;
+
+    // Nearest-place and radius queries over coordinates (built on first use)
+    const SpatialIndex& spatial() const;
+
+    // All cities in load order
+    const std::vector<City>& cities() const { return entries; }
+    size_t size() const { return entries.size(); }
+
+    // Position of a catalog city in cities()
+    uint32_t idOf(const City& city) const { return static_cast<uint32_t>(&city - entries.data()); }
+    // Whether city is one of cities(), so idOf() is meaningful
+    bool contains(const City& city) const {
+        return std::less_equal<const City*>()(entries.data(), &city) &&
+               std::less<const City*>()(&city, entries.data() + entries.size());
+    }
+
+    // Folder the CSV files were found in (empty if none were)
+    const std::string& dataDirectory() const { return dataDir; }
+
+    // Changes whenever any source CSV is added, removed or modified, so
+    // files derived from the catalog can tell when they are stale
+    uint64_t sourceFingerprint() const { return fingerprint; }
+
+    // True if the cities came from the binary snapshot, not the CSVs
+    bool loadedFromSnapshot() const { return snapshot.isOpen(); }
+
+    // Write the catalog, its name index and the source fingerprint to path
+    bool saveSnapshot(const std::string& path) const;
+
+    // Where the snapshot for these CSVs lives
+    std::string snapshotPath() const;
+
+private:
+    CityCatalog();
+    CityCatalog(const CityCatalog&) = delete;
+    CityCatalog& operator=(const CityCatalog&) = delete;
+
+    struct SourceFile {
+        std::string file;
+        CitySource source;
+        std::string path;   // empty if not found
+    };
+
+    // Find the CSV files (in directory, or the usual places if empty) and
+    // fingerprint them
+    void locateSources(const std::string& directory);
+    // Map the snapshot if it matches the CSVs
+    bool loadSnapshot(const std::string& path);
+    // Parse every CSV file in Data_Csv into entries
+    void loadAllCities();
+
+    std::vector<City> entries;
+    std::vector<SourceFile> sources;
+    std::string dataDir;
+    uint64_t fingerprint = 0;
+    // Backing storage for the names in entries
+    MappedFile snapshot;
+    std::vector<std::unique_ptr<CsvReader>> csvFiles;
+    // Normalized name -> index into entries
+    NameIndex byKey;
+
+    mutable std::once_flag fuzzyBuilt;
+    mutable std::unique_ptr<FuzzyMatcher> fuzzyMatcher;
+    mutable std::once_flag prefixBuilt;
+    mutable std::unique_ptr<PrefixIndex> prefixIndex;
+    mutable std::once_flag spatialBuilt;
+    mutable std::unique_ptr<SpatialIndex> spatialIndex;
+};
+
+#endif // CITY_CATALOG_H
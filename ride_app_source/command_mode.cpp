@@ -0,0 +1,332 @@
+#include "command_mode.h"
+#include "calendar_picker.h"
+#include "csv_reader.h"
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+
+using namespace std;
+
+static constexpr size_t MAX_FIELDS = 10;
+// Results are written out, after one journal sync, at this size
+static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+// yyyy-mm-dd
+static bool parseDate(string_view text, int& day, int& month, int& year) {
+    const char* at = text.data();
+    const char* end = text.data() + text.size();
+    auto part = [&](int& value, bool last) {
+        auto result = from_chars(at, end, value);
+        if (result.ec != errc()) return false;
+        at = result.ptr;
+        if (last) return at == end;
+        if (at == end || *at != '-') return false;
+        ++at;
+        return true;
+    };
+    return part(year, false) && part(month, false) && part(day, true) &&
+           year >= 1970 && year < (1 << 22) && day >= 1 && day <= daysInMonth(month, year);
+}
+
+static void today(int& day, int& month, int& year) {
+    time_t now = time(nullptr);
+    tm* localTime = localtime(&now);
+    day = localTime->tm_mday;
+    month = localTime->tm_mon + 1;
+    year = localTime->tm_year + 1900;
+}
+
+size_t CommandMode::run(istream& in, ostream& out) {
+    string line;
+    while (getline(in, line)) {
+        lineNumber++;
+        string_view command = trimView(line);
+        if (command.empty() || command[0] == '#') continue;
+        execute(command);
+        if (results.size() >= FLUSH_BYTES) flush(out);
+    }
+    flush(out);
+    out.flush();
+    return failures;
+}
+
+void CommandMode::flush(ostream& out) {
+    if (results.empty()) return;
+    // The results stand in memory either way; the failure says they were not saved
+    if (journal && !journal->waitDurable()) fail("journal", "changes could not be saved to disk");
+    out.write(results.data(), static_cast<streamsize>(results.size()));
+    results.clear();
+}
+
+void CommandMode::execute(string_view line) {
+    string_view fields[MAX_FIELDS];
+    size_t count = CsvReader::splitFields(line, fields, MAX_FIELDS);
+    string_view op = fields[0];
+    commands++;
+
+    if (op == "book") book(fields, count);
+    else if (op == "edit") edit(fields, count);
+    else if (op == "cancel") cancel(fields, count);
+    else if (op == "delete") remove(fields, count);
+    else if (op == "search") search(fields, count);
+    else if (op == "view") view(fields, count);
+    else if (op == "dispatch") dispatch(fields, count);
+    else fail(op, "unknown command");
+}
+
+void CommandMode::book(const string_view* fields, size_t count) {
+    if (count < 8) return fail("book", "expected first,last,phone,pickup,dropoff,vehicle,date[,persons[,ride id]]");
+
+    person p;
+    p.fname = fields[1];
+    p.lname = fields[2];
+    p.phone = fields[3];
+    const City* fromCity = place(fields[4]);
+    const City* toCity = place(fields[5]);
+    if (!fromCity) return fail("book", "unknown pickup");
+    if (!toCity) return fail("book", "unknown dropoff");
+    if (fromCity == toCity) return fail("book", "pickup and dropoff are the same place");
+    if (!vehicleFromName(fields[6], p.vehicle)) return fail("book", "unknown vehicle type");
+    int day, month, year;
+    if (!parseDate(fields[7], day, month, year)) return fail("book", "date must be yyyy-mm-dd");
+    p.setDate(day, month, year);
+    if (count > 8 && !fields[8].empty()) {
+        int persons = 0;
+        auto result = from_chars(fields[8].data(), fields[8].data() + fields[8].size(), persons);
+        if (result.ec != errc() || persons <= 0 || persons > 0xFFFF) return fail("book", "persons must be a positive number");
+        p.num_of_persons = static_cast<uint16_t>(persons);
+    }
+
+    const CityCatalog& cities = CityCatalog::instance();
+    p.pickup = cities.idOf(*fromCity);
+    p.dropoff = cities.idOf(*toCity);
+    p.ride_id = (count > 9 && !fields[9].empty()) ? string(fields[9]) : RideService::newRideId();
+
+    RideService::Booking booking = service.book(move(p));
+    const person& booked = *service.rides.get(booking.handle);
+    begin("book");
+    text("id", booked.ride_id);
+    integer("driver", booked.assignedDriverId);
+    if (booking.driverKm >= 0) number("driver_km", booking.driverKm);
+    number("km", booking.routeKm);
+    number("fare", booked.totalFare);
+    end();
+}
+
+void CommandMode::edit(const string_view* fields, size_t count) {
+    if (count < 4) return fail("edit", "expected ride id,field,value");
+    RideHandle handle = lookup("edit", fields[1]);
+    if (!handle.valid()) return;
+
+    const person& current = *service.rides.get(handle);
+    string_view field = fields[2];
+    string_view value = fields[3];
+    RideService::Outcome outcome;
+    if (field == "phone") {
+        outcome = service.edit(handle, [value](person& ride) { ride.phone = value; });
+    } else if (field == "pickup" || field == "dropoff") {
+        bool isPickup = field == "pickup";
+        const City* city = place(value);
+        if (!city) return fail("edit", "unknown place");
+        uint32_t id = CityCatalog::instance().idOf(*city);
+        if (id == (isPickup ? current.dropoff : current.pickup)) return fail("edit", "pickup and dropoff are the same place");
+        outcome = service.edit(handle, [id, isPickup](person& ride) { (isPickup ? ride.pickup : ride.dropoff) = id; });
+    } else if (field == "date") {
+        int day, month, year;
+        if (!parseDate(value, day, month, year)) return fail("edit", "date must be yyyy-mm-dd");
+        outcome = service.edit(handle, [=](person& ride) { ride.setDate(day, month, year); });
+    } else if (field == "vehicle") {
+        VehicleType vehicle;
+        if (!vehicleFromName(value, vehicle)) return fail("edit", "unknown vehicle type");
+        outcome = service.edit(handle, [vehicle](person& ride) { ride.vehicle = vehicle; });
+    } else {
+        return fail("edit", "field must be phone, pickup, dropoff, date or vehicle");
+    }
+
+    if (outcome != RideService::Outcome::Done) return fail("edit", RideService::describe(outcome));
+    begin("edit");
+    results += ",\"ride\":";
+    ride(*service.rides.get(handle));
+    end();
+}
+
+void CommandMode::cancel(const string_view* fields, size_t count) {
+    if (count < 2) return fail("cancel", "expected ride id");
+    RideHandle handle = lookup("cancel", fields[1]);
+    if (!handle.valid()) return;
+
+    RideService::Outcome outcome = service.cancel(handle);
+    if (outcome != RideService::Outcome::Done) return fail("cancel", RideService::describe(outcome));
+    begin("cancel");
+    text("id", fields[1]);
+    end();
+}
+
+void CommandMode::remove(const string_view* fields, size_t count) {
+    if (count < 2) return fail("delete", "expected ride id");
+    RideHandle handle = lookup("delete", fields[1]);
+    if (!handle.valid()) return;
+
+    service.remove(handle);
+    begin("delete");
+    text("id", fields[1]);
+    end();
+}
+
+void CommandMode::search(const string_view* fields, size_t count) {
+    if (count < 3) return fail("search", "expected first,last");
+
+    vector<RideHandle> found = service.rides.findByName(fields[1], fields[2]);
+    begin("search");
+    integer("count", static_cast<long long>(found.size()));
+    results += ",\"rides\":[";
+    for (size_t i = 0; i < found.size(); ++i) {
+        if (i > 0) results += ',';
+        ride(*service.rides.get(found[i]));
+    }
+    results += ']';
+    end();
+}
+
+void CommandMode::view(const string_view* fields, size_t count) {
+    if (count >= 2 && !fields[1].empty()) {
+        RideHandle handle = lookup("view", fields[1]);
+        if (!handle.valid()) return;
+        begin("view");
+        results += ",\"ride\":";
+        ride(*service.rides.get(handle));
+        end();
+        return;
+    }
+
+    begin("view");
+    integer("rides", static_cast<long long>(service.rides.size()));
+    for (size_t i = 0; i < RIDE_STATUS_COUNT; ++i) {
+        RideStatus status = static_cast<RideStatus>(i);
+        integer(statusName(status), static_cast<long long>(service.rides.countWithStatus(status)));
+    }
+    end();
+}
+
+void CommandMode::dispatch(const string_view* fields, size_t count) {
+    int day, month, year;
+    if (count >= 2 && !fields[1].empty()) {
+        if (!parseDate(fields[1], day, month, year)) return fail("dispatch", "date must be yyyy-mm-dd");
+    } else {
+        today(day, month, year);
+    }
+
+    RideService::Dispatch dispatched = service.dispatchPending(day, month, year);
+    const BatchDispatcher::Result& result = dispatched.result;
+    begin("dispatch");
+    integer("rides", static_cast<long long>(dispatched.rides.size()));
+    integer("matched", static_cast<long long>(result.matched));
+    number("km", result.totalKm);
+    number("greedy_km", result.greedyKm);
+    results += ",\"assignments\":[";
+    for (size_t i = 0; i < dispatched.rides.size(); ++i) {
+        if (i > 0) results += ',';
+        results += "{\"id\":";
+        quoted(service.rides.get(dispatched.rides[i])->ride_id);
+        integer("driver", result.driverIds[i]);
+        if (result.driverIds[i] != -1) number("driver_km", result.pickupKm[i]);
+        results += '}';
+    }
+    results += ']';
+    end();
+}
+
+RideHandle CommandMode::lookup(string_view op, string_view rideId) {
+    RideHandle handle = service.rides.findById(string(rideId));
+    if (!handle.valid()) fail(op, "ride not found");
+    return handle;
+}
+
+const City* CommandMode::place(string_view name) {
+    return calculator.findCity(CityCatalog::instance(), string(name));
+}
+
+void CommandMode::begin(string_view op) {
+    results += "{\"op\":";
+    quoted(op);
+    results += ",\"ok\":true";
+}
+
+void CommandMode::fail(string_view op, string_view error) {
+    failures++;
+    results += "{\"op\":";
+    quoted(op);
+    results += ",\"ok\":false";
+    integer("line", static_cast<long long>(lineNumber));
+    text("error", error);
+    end();
+}
+
+void CommandMode::text(string_view name, string_view value) {
+    results += ",\"";
+    results += name;
+    results += "\":";
+    quoted(value);
+}
+
+void CommandMode::quoted(string_view value) {
+    results += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': results += "\\\""; break;
+            case '\\': results += "\\\\"; break;
+            case '\n': results += "\\n"; break;
+            case '\t': results += "\\t"; break;
+            case '\r': results += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    results += escaped;
+                } else {
+                    results += c;
+                }
+        }
+    }
+    results += '"';
+}
+
+void CommandMode::number(string_view name, double value) {
+    char formatted[32];
+    snprintf(formatted, sizeof(formatted), "%.2f", value);
+    results += ",\"";
+    results += name;
+    results += "\":";
+    results += formatted;
+}
+
+void CommandMode::integer(string_view name, long long value) {
+    results += ",\"";
+    results += name;
+    results += "\":";
+    results += to_string(value);
+}
+
+void CommandMode::ride(const person& p) {
+    char date[16];
+    snprintf(date, sizeof(date), "%04u-%02u-%02u", static_cast<unsigned>(p.rideYear),
+             static_cast<unsigned>(p.rideMonth), static_cast<unsigned>(p.rideDay));
+    results += "{\"id\":";
+    quoted(p.ride_id);
+    text("first", p.fname);
+    text("last", p.lname);
+    text("phone", p.phone);
+    text("pickup", p.pickupCity().name);
+    text("dropoff", p.dropoffCity().name);
+    text("date", date);
+    text("vehicle", vehicleName(p.vehicle));
+    text("status", statusName(p.status));
+    integer("persons", p.num_of_persons);
+    integer("driver", p.assignedDriverId);
+    number("fare", p.totalFare);
+    results += '}';
+}
+
+void CommandMode::end() {
+    results += "}\n";
+}
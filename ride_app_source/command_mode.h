@@ -0,0 +1,77 @@
+#ifndef COMMAND_MODE_H
+#define COMMAND_MODE_H
+
+#include "distance_calculator.h"
+#include "ride_journal.h"
+#include "ride_service.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Drives the booking engine from a stream of commands instead of the
+// menus, for scripts and load tests. One command per line, fields split
+// on commas:
+//   book,<first>,<last>,<phone>,<pickup>,<dropoff>,<vehicle>,<yyyy-mm-dd>[,<persons>[,<ride id>]]
+//   edit,<ride id>,phone|pickup|dropoff|date|vehicle,<value>
+//   cancel,<ride id>
+//   delete,<ride id>
+//   search,<first>,<last>
+//   view[,<ride id>]
+//   dispatch[,<yyyy-mm-dd>]      (today if no date)
+// Without a ride id, book makes one up. Blank lines and lines starting
+// with # are skipped.
+//
+// Each command writes one JSON object on a line of its own, with "op",
+// "ok", and either its results or "line" and "error". Results are held
+// back until the journal has the changes on disk, then written a batch
+// at a time, so one fsync covers many commands. If the journal cannot
+// write them, a "journal" failure follows the batch.
+class CommandMode {
+public:
+    CommandMode(RideService& service, RideJournal* journal) : service(service), journal(journal) {}
+
+    // Run every command in `in`. Returns the number that failed.
+    size_t run(std::istream& in, std::ostream& out);
+
+    size_t commandCount() const { return commands; }
+
+private:
+    void execute(std::string_view line);
+    void book(const std::string_view* fields, size_t count);
+    void edit(const std::string_view* fields, size_t count);
+    void cancel(const std::string_view* fields, size_t count);
+    void remove(const std::string_view* fields, size_t count);
+    void search(const std::string_view* fields, size_t count);
+    void view(const std::string_view* fields, size_t count);
+    void dispatch(const std::string_view* fields, size_t count);
+
+    // The ride named by a command's id field, or an error written for it
+    RideHandle lookup(std::string_view op, std::string_view rideId);
+    const City* place(std::string_view name);
+
+    // Pieces of the JSON result lines
+    void begin(std::string_view op);
+    void fail(std::string_view op, std::string_view error);
+    void text(std::string_view name, std::string_view value);
+    void quoted(std::string_view value);
+    void number(std::string_view name, double value);
+    void integer(std::string_view name, long long value);
+    // The ride as an object of its own
+    void ride(const person& p);
+    void end();
+
+    // Write out what has collected once the journal has it
+    void flush(std::ostream& out);
+
+    RideService& service;
+    RideJournal* journal;
+    DistanceCalculator calculator;
+    std::string results;
+    size_t lineNumber = 0;
+    size_t commands = 0;
+    size_t failures = 0;
+};
+
+#endif // COMMAND_MODE_H
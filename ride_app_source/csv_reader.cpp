@@ -0,0 +1,65 @@
+#include "csv_reader.h"
+#include <charconv>
+#include <cstring>
+
+using namespace std;
+
+// Same set as trim(): whitespace and quote characters
+static inline bool isTrimChar(char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r': case '\f': case '\v': case '"': case '\'':
+            return true;
+        default:
+            return false;
+    }
+}
+
+string_view trimView(string_view text) {
+    size_t start = 0, end = text.size();
+    while (start < end && isTrimChar(text[start])) ++start;
+    while (end > start && isTrimChar(text[end - 1])) --end;
+    return text.substr(start, end - start);
+}
+
+bool parseDouble(string_view text, double& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    // from_chars rejects the leading '+' that stod accepts
+    if (first != last && *first == '+') ++first;
+    auto result = from_chars(first, last, value);
+    return result.ec == errc();
+}
+
+bool CsvReader::open(const string& path) {
+    pos = 0;
+    lineNum = 0;
+    return file.open(path);
+}
+
+bool CsvReader::nextLine(string_view& line) {
+    const char* data = file.data();
+    size_t size = file.size();
+
+    while (pos < size) {
+        const char* start = data + pos;
+        const char* newline = static_cast<const char*>(memchr(start, '\n', size - pos));
+        size_t length = newline ? static_cast<size_t>(newline - start) : size - pos;
+        pos += length + (newline ? 1 : 0);
+        lineNum++;
+
+        line = trimView(string_view(start, length));
+        if (!line.empty()) return true;
+    }
+    return false;
+}
+
+size_t CsvReader::splitFields(string_view line, string_view* fields, size_t maxFields) {
+    size_t count = 0;
+    while (count < maxFields) {
+        size_t comma = (count + 1 < maxFields) ? line.find(',') : string_view::npos;
+        fields[count++] = trimView(line.substr(0, comma));
+        if (comma == string_view::npos) break;
+        line.remove_prefix(comma + 1);
+    }
+    return count;
+}
@@ -0,0 +1,41 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include "mapped_file.h"
+#include <string>
+#include <string_view>
+
+// Reads a memory-mapped CSV file line by line. Lines and fields are views
+// into the mapping, so nothing is copied until the caller keeps a value.
+class CsvReader {
+public:
+    bool open(const std::string& path);
+
+    // Next line with surrounding whitespace and quotes trimmed, skipping
+    // blank lines. False at end of file.
+    bool nextLine(std::string_view& line);
+
+    // 1-based number of the line last returned
+    int lineNumber() const { return lineNum; }
+
+    // Rough row count, for reserving storage up front
+    size_t estimateRows(size_t bytesPerRow) const { return file.size() / bytesPerRow + 1; }
+
+    // Split line into at most maxFields fields on commas; the last field
+    // keeps any further commas. Each field is trimmed. Returns the count.
+    static size_t splitFields(std::string_view line, std::string_view* fields, size_t maxFields);
+
+private:
+    MappedFile file;
+    size_t pos = 0;
+    int lineNum = 0;
+};
+
+// Strip whitespace and quote characters from both ends, like trim()
+std::string_view trimView(std::string_view text);
+
+// Parse a decimal number the way stod() does, without allocating.
+// False if text does not start with a number.
+bool parseDouble(std::string_view text, double& value);
+
+#endif // CSV_READER_H
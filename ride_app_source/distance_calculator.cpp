@@ -1,17 +1,16 @@
 #include "distance_calculator.h"
+#include "city_catalog.h"
+#include "transit_router.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <cmath>
-#include <filesystem>
 #include <iomanip>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <vector>
 #include <limits>
 
 using namespace std;
-namespace fs = std::filesystem;
 
 // Static member initialization
 const map<string, VehicleRate> DistanceCalculator::VEHICLE_RATES = {
@@ -34,7 +33,7 @@ string trim(const string& s) {
     return (start == string::npos) ? "" : s.substr(start, end - start + 1);
 }
 
-string normalizeName(const string& s) {
+string normalizeName(string_view s) {
     string result;
     for (char c : s) {
         if (isalnum(c)) {
@@ -44,189 +43,138 @@ string normalizeName(const string& s) {
     return result;
 }
 
-// Member function implementations
-map<string, City> DistanceCalculator::loadAllCities() {
-    map<string, City> cities;
-    vector<string> csv_files = {
-        "Cities.csv", "Ejeep.csv", "LRT-2.csv", "LRT.csv",
-        "Major_Bus.csv", "MRT-3.csv", "PNR.csv"
-    };
-
-    for (const auto& file : csv_files) {
-        vector<fs::path> possible_paths = {
-            fs::current_path() / "Data_Csv" / file,
-            fs::current_path().parent_path() / "Data_Csv" / file,
-            fs::current_path() / file,
-            fs::current_path().parent_path() / file
-        };
-
-        fs::path csv_path;
-        bool found = false;
-        
-        for (const auto& path : possible_paths) {
-            if (fs::exists(path)) {
-                csv_path = path;
-                found = true;
-                break;
-            }
-        }
+double haversineKm(double lat1, double lon1, double lat2, double lon2) {
+    constexpr double R = 6371.0;
+    constexpr double PI_DIV_180 = M_PI / 180.0;
 
-        if (!found) {
-            cerr << "Warning: File not found in any searched location - " << file << endl;
-            continue;
-        }
+    double dlat = (lat2 - lat1) * PI_DIV_180;
+    double dlon = (lon2 - lon1) * PI_DIV_180;
 
-        ifstream file_stream(csv_path);
-        if (!file_stream.is_open()) {
-            cerr << "Error: Could not open " << csv_path << endl;
-            continue;
-        }
+    double a_harv = sin(dlat/2) * sin(dlat/2) +
+                    cos(lat1 * PI_DIV_180) * cos(lat2 * PI_DIV_180) * sin(dlon/2) * sin(dlon/2);
+    return 2 * R * atan2(sqrt(a_harv), sqrt(1-a_harv));
+}
 
-        string line;
-        int line_num = 0;
-        int loaded = 0;
-
-        while (getline(file_stream, line)) {
-            line_num++;
-            line = trim(line);
-            if (line.empty() || line_num == 1) continue;
-
-            stringstream ss(line);
-            string name, lat_str, lon_str;
-
-            try {
-                getline(ss, name, ',');
-                getline(ss, lat_str, ',');
-                getline(ss, lon_str);
-
-                name = trim(name);
-                lat_str = trim(lat_str);
-                lon_str = trim(lon_str);
-
-                if (name.empty() || lat_str.empty() || lon_str.empty()) {
-                    cerr << "Warning: Incomplete data in " << file << " at line " << line_num << endl;
-                    continue;
-                }
-
-                // Create normalized version for flexible matching
-                string normalized = normalizeName(name);
-                
-                // Check for duplicates using normalized name
-                bool duplicate = false;
-                for (const auto& pair : cities) {
-                    if (normalizeName(pair.first) == normalized) {
-                        cerr << "Warning: Duplicate city found - " << name 
-                             << " (similar to " << pair.first << ") in " << file << endl;
-                        duplicate = true;
-                        break;
-                    }
-                }
-                if (duplicate) continue;
-
-                cities[name] = {
-                    name,
-                    stod(lat_str),
-                    stod(lon_str)
-                };
-                loaded++;
-            } catch (const exception& e) {
-                cerr << "Error parsing line " << line_num << " in " << file << ": " << e.what() << endl;
-                cerr << "Problematic line: " << line << endl;
-            }
-        }
+// Member function implementations
+double DistanceCalculator::calculateDistance(const City& a, const City& b) {
+    return haversineKm(a.lat, a.lon, b.lat, b.lon);
+}
 
-        
-    }
+const City* DistanceCalculator::findCity(const CityCatalog& cities, const string& name) {
+    const City* city = cities.find(name);
+    if (city) return city;
 
-    
-    return cities;
+    // Covers trimmed input too: spaces and quotes are not part of the key
+    return cities.findNormalized(name);
 }
 
-double DistanceCalculator::calculateDistance(const City& a, const City& b) {
-    constexpr double R = 6371.0;
-    constexpr double PI_DIV_180 = M_PI / 180.0;
+vector<const City*> DistanceCalculator::showSuggestions(const CityCatalog& cities, const string& name) {
+    const size_t limit = 5;
 
-    double lat1 = a.lat * PI_DIV_180;
-    double lat2 = b.lat * PI_DIV_180;
-    double dlat = (b.lat - a.lat) * PI_DIV_180;
-    double dlon = (b.lon - a.lon) * PI_DIV_180;
+    // Completions of what was typed first, then names that are a typo away
+    vector<const City*> shown = cities.complete(name, limit);
+    for (const auto& match : cities.fuzzy().suggest(name, limit)) {
+        if (shown.size() == limit) break;
+        if (find(shown.begin(), shown.end(), match.city) == shown.end()) {
+            shown.push_back(match.city);
+        }
+    }
+    if (shown.empty()) return shown;
 
-    double a_harv = sin(dlat/2) * sin(dlat/2) + cos(lat1) * cos(lat2) * sin(dlon/2) * sin(dlon/2);
-    return 2 * R * atan2(sqrt(a_harv), sqrt(1-a_harv));
+    cout << "Did you mean one of these?" << endl;
+    for (size_t i = 0; i < shown.size(); ++i) {
+        cout << " " << (i + 1) << ". " << shown[i]->name << endl;
+    }
+    return shown;
 }
 
-const City* DistanceCalculator::findCity(const map<string, City>& cities, const string& name) {
-    auto it = cities.find(name);
-    if (it != cities.end()) return &it->second;
-
-    string trimmed = trim(name);
-    it = cities.find(trimmed);
-    if (it != cities.end()) return &it->second;
+void DistanceCalculator::showNearestStations(const CityCatalog& cities, const City& place) {
+    auto stations = cities.spatial().nearest(place.lat, place.lon, 3, RAIL_STATIONS);
+    if (stations.empty()) return;
 
-    string normalized = normalizeName(name);
-    for (const auto& pair : cities) {
-        if (normalizeName(pair.first) == normalized) {
-            return &pair.second;
-        }
+    cout << "Nearest stations to " << place.name << ":" << endl;
+    cout << fixed << setprecision(2);
+    for (const auto& station : stations) {
+        cout << " - " << station.city->name << " (" << station.distanceKm << " km)" << endl;
     }
-    return nullptr;
 }
 
-void DistanceCalculator::showSuggestions(const map<string, City>& cities, const string& name) {
-    string normalized = normalizeName(name);
-    cout << "Did you mean one of these?" << endl;
-    for (const auto& pair : cities) {
-        if (pair.first.find(name) != string::npos || 
-            normalizeName(pair.first).find(normalized) != string::npos) {
-            cout << " - " << pair.first << endl;
+double DistanceCalculator::showTransitRoute(const TransitRouter& router, const City& from, const City& to) {
+    TransitRouter::Route route = router.route(from, to);
+    if (!route.found || route.legs.empty()) return -1;
+
+    cout << "Transit route (" << fixed << setprecision(2) << route.km << " km):" << endl;
+    for (const auto& leg : route.legs) {
+        switch (leg.mode) {
+            case TransitRouter::Mode::Line:
+                cout << " - Ride " << sourceName(leg.line) << " from " << leg.from->name << " to "
+                     << leg.to->name << " (" << leg.stops << (leg.stops == 1 ? " stop, " : " stops, ");
+                break;
+            case TransitRouter::Mode::Transfer:
+                cout << " - Transfer from " << leg.from->name << " to " << leg.to->name << " (";
+                break;
+            case TransitRouter::Mode::Walk:
+                cout << " - Walk from " << leg.from->name << " to " << leg.to->name << " (";
+                break;
         }
+        cout << leg.km << " km)" << endl;
     }
+    return route.km;
 }
 
-void DistanceCalculator::printAllCities(const map<string, City>& cities) {
+void DistanceCalculator::printAllCities(const CityCatalog& cities) {
     cout << "\n=== Available Locations (" << cities.size() << ") ===" << endl;
-    for (const auto& pair : cities) {
-        cout << pair.first << endl;
+    for (const auto& city : cities.cities()) {
+        cout << city.name << endl;
     }
     cout << "==============================" << endl;
 }
 
-pair<const City*, const City*> DistanceCalculator::selectLocations(const map<string, City>& cities) {
-    string from, to;
-    const City* fromCity = nullptr;
-    const City* toCity = nullptr;
-
+pair<const City*, const City*> DistanceCalculator::selectLocations(const CityCatalog& cities) {
     // Clear any leftover input
     cin.clear();
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-    // Pickup location selection
+    const City* fromCity = promptLocation(cities, "pickup", nullptr);
+    const City* toCity = promptLocation(cities, "dropoff", fromCity);
+
+    return {fromCity, toCity};
+}
+
+const City* DistanceCalculator::promptLocation(const CityCatalog& cities, const string& label, const City* other,
+                                               const string& otherLabel) {
+    vector<const City*> suggestions;
+    string input;
+
     while (true) {
-        cout << "\nEnter pickup location: ";
-        getline(cin, from);
-        fromCity = findCity(cities, from);
-        if (!fromCity) {
-            cout << "\nNo matching locations found! Please try again!" << endl;
-        } else {
-            break;
+        cout << "\nEnter " << label << " location: ";
+        getline(cin, input);
+
+        const City* city = findCity(cities, input);
+
+        // A number picks one of the suggestions shown for the last attempt
+        // (a number too long to parse is just no such suggestion)
+        string choice = trim(input);
+        if (!city && !suggestions.empty() && !choice.empty()) {
+            size_t pick = 0;
+            auto parsed = from_chars(choice.data(), choice.data() + choice.size(), pick);
+            if (parsed.ec == errc() && parsed.ptr == choice.data() + choice.size() &&
+                pick >= 1 && pick <= suggestions.size()) {
+                city = suggestions[pick - 1];
+            }
         }
-    }
 
-    // Dropoff location selection
-    while (true) {
-        cout << "\nEnter dropoff location: ";
-        getline(cin, to);
-        toCity = findCity(cities, to);
-        if (!toCity) {
-            cout << "\nNo matching locations found! Please try again!" << endl;
-        } else if (to == from) {
-            cout << "Dropoff cannot be the same as pickup!" << endl;
+        if (!city) {
+            suggestions = showSuggestions(cities, input);
+            if (suggestions.empty()) {
+                cout << "\nNo matching locations found! Please try again!" << endl;
+            } else {
+                cout << "Enter a number to pick one, or type the location again." << endl;
+            }
+        } else if (city == other) {
+            cout << "That is already the " << otherLabel << "! Please choose another location." << endl;
         } else {
-            break;
+            return city;
         }
     }
-
-    return {fromCity, toCity};
 }
-
-
@@ -1,36 +1,66 @@
 #ifndef DISTANCE_CALCULATOR_H
 #define DISTANCE_CALCULATOR_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
+
+class CityCatalog;
+class TransitRouter;
+
+// Which Data_Csv file a place was loaded from
+enum class CitySource : uint8_t {
+    Cities, Ejeep, LRT2, LRT, MajorBus, MRT3, PNR
+};
 
 struct City {
-    std::string name;
+    std::string_view name;   // owned by the CityCatalog
     double lat, lon;
+    CitySource source = CitySource::Cities;
 };
 
 struct VehicleRate {
     double baseFare;
     double perKmRate;
 };
+// Helper functions shared with the city catalog
+std::string trim(const std::string& s);
+std::string normalizeName(std::string_view s);
+
+// Great-circle distance in km between two points given in degrees, for
+// one pair at a time (batch_distance.h has the kernels for many)
+double haversineKm(double lat1, double lon1, double lat2, double lon2);
+
 class DistanceCalculator {
 public:
-    // Load all cities from CSV files
-    std::map<std::string, City> loadAllCities();
     // In DistanceCalculator.h
-    std::pair<const City*, const City*> selectLocations(const std::map<std::string, City>& cities);
+    std::pair<const City*, const City*> selectLocations(const CityCatalog& cities);
     
     // Calculate distance between two cities
     double calculateDistance(const City& a, const City& b);
     
     // Find a city by name (with flexible matching)
-    const City* findCity(const std::map<std::string, City>& cities, const std::string& name);
+    const City* findCity(const CityCatalog& cities, const std::string& name);
+    
+    // Prompt until the input names a city (or picks a suggestion) other
+    // than `other`, the ride's otherLabel ("pickup" or "dropoff")
+    const City* promptLocation(const CityCatalog& cities, const std::string& label, const City* other,
+                               const std::string& otherLabel = "pickup");
     
-    // Show suggestions for similar city names
-    void showSuggestions(const std::map<std::string, City>& cities, const std::string& name);
+    // Show numbered suggestions for similar city names, closest first
+    std::vector<const City*> showSuggestions(const CityCatalog& cities, const std::string& name);
     
+    // Show the rail stations closest to a place
+    void showNearestStations(const CityCatalog& cities, const City& place);
+
+    // Print the transit route between two places, leg by leg.
+    // Returns the route length in km, or -1 if there is no route.
+    double showTransitRoute(const TransitRouter& router, const City& from, const City& to);
+
     // Print all loaded cities (for debugging)
-    void printAllCities(const std::map<std::string, City>& cities);
+    void printAllCities(const CityCatalog& cities);
     
     // Vehicle rates
     static const std::map<std::string, VehicleRate> VEHICLE_RATES;
@@ -0,0 +1,135 @@
+#include "distance_matrix.h"
+#include "batch_distance.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char MATRIX_MAGIC[4] = {'G', 'R', 'D', 'M'};
+static constexpr uint32_t MATRIX_VERSION = 1;
+static const char* MATRIX_FILE = "city_distances.bin";
+
+struct MatrixHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t fingerprint;
+};
+
+// Slot of pair (i, j), i < j, in the packed upper triangle
+static inline size_t pairIndex(size_t i, size_t j, size_t n) {
+    return i * (2 * n - i - 1) / 2 + (j - i - 1);
+}
+
+const DistanceMatrix& DistanceMatrix::instance() {
+    static const DistanceMatrix matrix(CityCatalog::instance());
+    return matrix;
+}
+
+DistanceMatrix::DistanceMatrix(const CityCatalog& catalog) : catalog(catalog) {
+    if (catalog.size() < 2 || catalog.size() > MAX_CITIES) return;
+
+    string path = (fs::path(catalog.dataDirectory()) / MATRIX_FILE).string();
+    if (open(path)) return;
+
+    if (build(catalog, path) && open(path)) return;
+    cerr << "Warning: Distance table unavailable, computing distances on demand" << endl;
+}
+
+bool DistanceMatrix::open(const string& path) {
+    if (!file.open(path)) return false;
+
+    MatrixHeader header;
+    size_t n = catalog.size();
+    size_t expected = sizeof(MatrixHeader) + n * (n - 1) / 2 * sizeof(float);
+    if (file.size() != expected) {
+        file.close();
+        return false;
+    }
+
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, MATRIX_MAGIC, 4) != 0 || header.version != MATRIX_VERSION ||
+        header.count != n || header.fingerprint != catalog.sourceFingerprint()) {
+        file.close();
+        return false;
+    }
+
+    table = reinterpret_cast<const float*>(file.data() + sizeof(MatrixHeader));
+    count = static_cast<uint32_t>(n);
+    return true;
+}
+
+double DistanceMatrix::distance(uint32_t a, uint32_t b) const {
+    if (a == b) return 0.0;
+    if (a > b) swap(a, b);
+    return table[pairIndex(a, b, count)];
+}
+
+double DistanceMatrix::distance(const City& a, const City& b) const {
+    // Cities from another catalog have no row in this table
+    if (!isLoaded() || !catalog.contains(a) || !catalog.contains(b)) {
+        DistanceCalculator calculator;
+        return calculator.calculateDistance(a, b);
+    }
+    return distance(catalog.idOf(a), catalog.idOf(b));
+}
+
+bool DistanceMatrix::build(const CityCatalog& catalog, const string& path) {
+    size_t n = catalog.size();
+    if (n < 2) return false;
+
+    GeoPoints points = GeoPoints::fromCities(catalog.cities());
+    vector<float> triangle(n * (n - 1) / 2);
+
+    // Row i holds n - i - 1 pairs, so rows are dealt out round-robin to
+    // keep the threads evenly loaded
+    unsigned threadCount = max(1u, thread::hardware_concurrency());
+    vector<thread> workers;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t] {
+            vector<double> row(n);
+            for (size_t i = t; i + 1 < n; i += threadCount) {
+                distancesFrom(points, i, row.data(), i + 1);
+                float* out = &triangle[pairIndex(i, i + 1, n)];
+                for (size_t j = 0; j < n - i - 1; ++j) {
+                    out[j] = static_cast<float>(row[j]);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    MatrixHeader header = {};
+    memcpy(header.magic, MATRIX_MAGIC, 4);
+    header.version = MATRIX_VERSION;
+    header.count = static_cast<uint32_t>(n);
+    header.fingerprint = catalog.sourceFingerprint();
+
+    // Write beside the target and rename, so a crash never leaves a
+    // half-written table that looks valid
+    string temp = path + ".tmp";
+    bool written;
+    {
+        ofstream out(temp, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(triangle.data()), triangle.size() * sizeof(float));
+        out.close();
+        written = !out.fail();
+    }
+
+    error_code ec;
+    if (written) fs::rename(temp, path, ec);
+    if (!written || ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
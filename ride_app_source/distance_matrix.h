@@ -0,0 +1,45 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "city_catalog.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+
+// Precomputed distances between every pair of catalog cities, stored as a
+// packed upper triangle of floats in a file next to the CSVs and memory
+// mapped on startup. The file records the catalog's source fingerprint and
+// is rebuilt whenever a CSV changes.
+class DistanceMatrix {
+public:
+    // Catalogs larger than this skip the table (it grows with n^2)
+    static constexpr uint32_t MAX_CITIES = 8192;
+
+    // The shared table for CityCatalog::instance(), opened or built on the
+    // first distance asked for
+    static const DistanceMatrix& instance();
+
+    // Distance in km; falls back to calculateDistance() when no table is loaded
+    double distance(const City& a, const City& b) const;
+
+    // Distance in km between two catalog ids; requires isLoaded()
+    double distance(uint32_t a, uint32_t b) const;
+
+    bool isLoaded() const { return table != nullptr; }
+
+    // Compute the table for a catalog on all cores and save it to path
+    static bool build(const CityCatalog& catalog, const std::string& path);
+
+private:
+    explicit DistanceMatrix(const CityCatalog& catalog);
+
+    // Map the table at path if it matches the catalog
+    bool open(const std::string& path);
+
+    const CityCatalog& catalog;
+    MappedFile file;
+    const float* table = nullptr;
+    uint32_t count = 0;
+};
+
+#endif // DISTANCE_MATRIX_H
@@ -0,0 +1,166 @@
+#include "driver_grid.h"
+#include "distance_calculator.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static constexpr double DEG_TO_RAD = M_PI / 180.0;
+static constexpr int32_t CELL_BIAS = 1 << 23;
+
+int32_t DriverGrid::cellOf(double degrees) {
+    return static_cast<int32_t>(floor(degrees / CELL_DEG));
+}
+
+uint64_t DriverGrid::cellKey(uint16_t layer, int32_t row, int32_t col) {
+    // 16 bits of layer, 24 bits each of biased row and column
+    return (uint64_t(layer) << 48) | (uint64_t(uint32_t(row + CELL_BIAS) & 0xFFFFFF) << 24) |
+           uint64_t(uint32_t(col + CELL_BIAS) & 0xFFFFFF);
+}
+
+void DriverGrid::addToCell(uint32_t id, uint64_t cell, float lat, float lon) {
+    vector<Item>& items = cells[cell];
+    places[id] = {cell, static_cast<uint32_t>(items.size())};
+    items.push_back({id, lat, lon});
+}
+
+void DriverGrid::removeFromCell(uint32_t id) {
+    Place& place = places[id];
+    auto it = cells.find(place.cell);
+    vector<Item>& items = it->second;
+
+    // Swap the last item into the hole
+    items[place.index] = items.back();
+    places[items[place.index].id].index = place.index;
+    items.pop_back();
+    if (items.empty()) cells.erase(it);
+    place.cell = NO_CELL;
+}
+
+void DriverGrid::insert(uint32_t id, uint16_t layer, double lat, double lon) {
+    if (id >= places.size()) places.resize(max<size_t>(id + 1, places.size() * 2));
+    if (layer >= layerSizes.size()) layerSizes.resize(layer + 1, 0);
+    if (places[id].cell != NO_CELL) return;
+
+    addToCell(id, cellKey(layer, cellOf(lat), cellOf(lon)), static_cast<float>(lat), static_cast<float>(lon));
+    layerSizes[layer]++;
+    count++;
+}
+
+void DriverGrid::move(uint32_t id, double lat, double lon) {
+    if (!contains(id)) return;
+
+    Place& place = places[id];
+    uint16_t layer = static_cast<uint16_t>(place.cell >> 48);
+    uint64_t cell = cellKey(layer, cellOf(lat), cellOf(lon));
+    if (cell == place.cell) {
+        // Most position updates stay inside the cell
+        Item& item = cells[cell][place.index];
+        item.lat = static_cast<float>(lat);
+        item.lon = static_cast<float>(lon);
+        return;
+    }
+    removeFromCell(id);
+    addToCell(id, cell, static_cast<float>(lat), static_cast<float>(lon));
+}
+
+void DriverGrid::remove(uint32_t id) {
+    if (!contains(id)) return;
+    layerSizes[places[id].cell >> 48]--;
+    removeFromCell(id);
+    count--;
+}
+
+template <typename Scan, typename Done>
+void DriverGrid::searchRings(uint16_t layer, double lat, double lon, double lonScale, Scan scan, Done done) const {
+    int32_t row = cellOf(lat), col = cellOf(lon);
+    // Past this many rings, checking every occupied cell is cheaper
+    size_t ringLimit = static_cast<size_t>(sqrt(static_cast<double>(cells.size()))) + 1;
+    for (int32_t r = 0; static_cast<size_t>(r) <= ringLimit; ++r) {
+        for (int32_t i = row - r; i <= row + r; ++i) {
+            // Whole rows at the top and bottom, just the two ends elsewhere
+            int32_t step = (i == row - r || i == row + r) ? 1 : max(1, 2 * r);
+            for (int32_t j = col - r; j <= col + r; j += step) {
+                auto it = cells.find(cellKey(layer, i, j));
+                if (it != cells.end()) scan(it->second);
+            }
+        }
+        // Anything outside rings 0..r is at least r cells away
+        if (done(r * CELL_DEG * min(1.0, lonScale))) return;
+    }
+
+    // Whatever the rings didn't reach
+    int32_t reached = static_cast<int32_t>(ringLimit);
+    for (const auto& entry : cells) {
+        if ((entry.first >> 48) != layer) continue;
+        int32_t i = static_cast<int32_t>((entry.first >> 24) & 0xFFFFFF) - CELL_BIAS;
+        int32_t j = static_cast<int32_t>(entry.first & 0xFFFFFF) - CELL_BIAS;
+        if (abs(i - row) > reached || abs(j - col) > reached) scan(entry.second);
+    }
+}
+
+uint32_t DriverGrid::nearest(uint16_t layer, double lat, double lon, double* distanceKm) const {
+    if (layer >= layerSizes.size() || layerSizes[layer] == 0) return NOT_FOUND;
+
+    // Compare in a local flat projection; at city scale it orders points
+    // the same way great-circle distance does
+    double lonScale = cos(lat * DEG_TO_RAD);
+    uint32_t best = NOT_FOUND;
+    float bestLat = 0, bestLon = 0;
+    double bestSq = INFINITY;
+
+    auto scan = [&](const vector<Item>& items) {
+        for (const Item& item : items) {
+            double dy = item.lat - lat;
+            double dx = (item.lon - lon) * lonScale;
+            double sq = dx * dx + dy * dy;
+            if (sq < bestSq) {
+                bestSq = sq;
+                best = item.id;
+                bestLat = item.lat;
+                bestLon = item.lon;
+            }
+        }
+    };
+    searchRings(layer, lat, lon, lonScale, scan, [&](double reach) {
+        return best != NOT_FOUND && bestSq <= reach * reach;
+    });
+
+    if (distanceKm) *distanceKm = haversineKm(lat, lon, bestLat, bestLon);
+    return best;
+}
+
+vector<uint32_t> DriverGrid::nearest(uint16_t layer, double lat, double lon, size_t k) const {
+    vector<uint32_t> result;
+    if (k == 0 || layer >= layerSizes.size() || layerSizes[layer] == 0) return result;
+    k = min<size_t>(k, layerSizes[layer]);
+
+    double lonScale = cos(lat * DEG_TO_RAD);
+    // Max-heap of the k closest so far, farthest on top
+    vector<pair<double, uint32_t>> heap;
+    heap.reserve(k + 1);
+
+    auto scan = [&](const vector<Item>& items) {
+        for (const Item& item : items) {
+            double dy = item.lat - lat;
+            double dx = (item.lon - lon) * lonScale;
+            double sq = dx * dx + dy * dy;
+            if (heap.size() < k) {
+                heap.push_back({sq, item.id});
+                push_heap(heap.begin(), heap.end());
+            } else if (sq < heap.front().first) {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = {sq, item.id};
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+    searchRings(layer, lat, lon, lonScale, scan, [&](double reach) {
+        return heap.size() == k && heap.front().first <= reach * reach;
+    });
+
+    sort_heap(heap.begin(), heap.end());
+    result.reserve(heap.size());
+    for (const auto& entry : heap) result.push_back(entry.second);
+    return result;
+}
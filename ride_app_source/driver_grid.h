@@ -0,0 +1,72 @@
+#ifndef DRIVER_GRID_H
+#define DRIVER_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform lat/lon grid of moving points, split into layers (one per
+// vehicle type). Unlike SpatialIndex, which is built once over the fixed
+// catalog, points here are inserted, moved and removed all the time, each
+// in O(1). Nearest queries search rings of cells outward from the query
+// until no closer point can remain.
+class DriverGrid {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+    // About 1.1 km of latitude per cell
+    static constexpr double CELL_DEG = 0.01;
+
+    // Add point id (not already in the grid) to a layer
+    void insert(uint32_t id, uint16_t layer, double lat, double lon);
+
+    // Move a point in the grid to a new position
+    void move(uint32_t id, double lat, double lon);
+
+    // Take a point out of the grid (no-op if it isn't in it)
+    void remove(uint32_t id);
+
+    bool contains(uint32_t id) const { return id < places.size() && places[id].cell != NO_CELL; }
+
+    // Closest point in a layer to (lat, lon), NOT_FOUND if the layer is
+    // empty. distanceKm gets the great-circle distance.
+    uint32_t nearest(uint16_t layer, double lat, double lon, double* distanceKm = nullptr) const;
+
+    // Up to k points in a layer closest to (lat, lon), closest first
+    std::vector<uint32_t> nearest(uint16_t layer, double lat, double lon, size_t k) const;
+
+    size_t size() const { return count; }
+
+private:
+    static constexpr uint64_t NO_CELL = ~uint64_t(0);
+
+    struct Item {
+        uint32_t id;
+        float lat, lon;
+    };
+    // Where a point lives: its cell and its position in that cell's list
+    struct Place {
+        uint64_t cell = NO_CELL;
+        uint32_t index = 0;
+    };
+
+    static int32_t cellOf(double degrees);
+    static uint64_t cellKey(uint16_t layer, int32_t row, int32_t col);
+
+    // Visit the layer's cells ring by ring around (lat, lon) until
+    // done(reach) says no closer point can lie beyond reach (in projected
+    // degrees), or every occupied cell has been seen
+    template <typename Scan, typename Done>
+    void searchRings(uint16_t layer, double lat, double lon, double lonScale, Scan scan, Done done) const;
+
+    // Append to a cell, or swap-remove from it, keeping places in sync
+    void addToCell(uint32_t id, uint64_t cell, float lat, float lon);
+    void removeFromCell(uint32_t id);
+
+    std::unordered_map<uint64_t, std::vector<Item>> cells;
+    std::vector<Place> places;   // indexed by point id
+    std::vector<uint32_t> layerSizes;
+    size_t count = 0;
+};
+
+#endif // DRIVER_GRID_H
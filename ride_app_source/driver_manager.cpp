@@ -0,0 +1,259 @@
+#include "driver_manager.h"
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// Vehicles handed out to roster drivers that have no vehicle column
+static const char* ROAD_VEHICLES[] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus"};
+static constexpr size_t ROAD_VEHICLE_COUNT = sizeof(ROAD_VEHICLES) / sizeof(ROAD_VEHICLES[0]);
+static constexpr size_t MAX_COLUMNS = 16;
+
+void DriverManager::reserve(size_t count) {
+    drivers.reserve(count);
+    slotOf.reserve(count);
+}
+
+int DriverManager::vehicleIndex(string_view vehicle) const {
+    // Few enough types that a scan beats hashing the name
+    for (size_t i = 0; i < vehicleNames.size(); ++i) {
+        if (vehicleNames[i] == vehicle) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+uint16_t DriverManager::internVehicle(string_view vehicle) {
+    int index = vehicleIndex(vehicle);
+    if (index >= 0) return static_cast<uint16_t>(index);
+    vehicleNames.emplace_back(vehicle);
+    freeByVehicle.emplace_back();
+    freeCounts.push_back(0);
+    return static_cast<uint16_t>(vehicleNames.size() - 1);
+}
+
+string_view DriverManager::keep(const string& text) {
+    ownedText.push_back(text);
+    return ownedText.back();
+}
+
+bool DriverManager::addDriver(int id, const string& name, const string& phone, const string& vehicle,
+                              float rating, const string& plate) {
+    if (slotOf.count(id)) {
+        cerr << "Warning: Driver id " << id << " is already taken; skipping " << name << endl;
+        return false;
+    }
+    return add(id, keep(name), keep(phone), vehicle, rating, plate.empty() ? string_view() : keep(plate));
+}
+
+bool DriverManager::add(int id, string_view name, string_view phone, string_view vehicle,
+                        float rating, string_view plate) {
+    // Every lookup goes by id, so a second driver with one could never be
+    // found, released or claimed
+    uint32_t slot = static_cast<uint32_t>(drivers.size());
+    if (!slotOf.emplace(id, slot).second) return false;
+
+    uint16_t vehicleId = internVehicle(vehicle);
+    Driver driver = {id, name, phone, vehicleNames[vehicleId], plate, rating, vehicleId};
+    drivers.push_back(driver);
+    freeByVehicle[vehicleId].push_back({slot, 0});
+    freeCounts[vehicleId]++;
+    return true;
+}
+
+size_t DriverManager::loadFromCsv(const string& path) {
+    unique_ptr<CsvReader> reader(new CsvReader());
+    if (!reader->open(path)) {
+        cerr << "Warning: Could not open driver roster " << path << endl;
+        return 0;
+    }
+
+    // Rows look like  1001,Heidi Carlson,9454781216,44,4.2,KET 153
+    string_view line;
+    string_view fields[MAX_COLUMNS];
+    if (!reader->nextLine(line)) return 0;
+
+    int idCol = -1, nameCol = -1, phoneCol = -1, ratingCol = -1, plateCol = -1, vehicleCol = -1;
+    int latCol = -1, lonCol = -1;
+    size_t columns = CsvReader::splitFields(line, fields, MAX_COLUMNS);
+    for (size_t c = 0; c < columns; ++c) {
+        int col = static_cast<int>(c);
+        if (fields[c] == "rider_id" || fields[c] == "driver_id" || fields[c] == "id") idCol = col;
+        else if (fields[c] == "name") nameCol = col;
+        else if (fields[c] == "phone") phoneCol = col;
+        else if (fields[c] == "rating") ratingCol = col;
+        else if (fields[c] == "license_plate" || fields[c] == "plate") plateCol = col;
+        else if (fields[c] == "vehicle") vehicleCol = col;
+        else if (fields[c] == "latitude" || fields[c] == "lat") latCol = col;
+        else if (fields[c] == "longitude" || fields[c] == "lon") lonCol = col;
+    }
+    if (idCol < 0 || nameCol < 0) {
+        cerr << "Warning: Driver roster " << path << " has no id or name column" << endl;
+        return 0;
+    }
+
+    // Reserve once from the file size, so the single pass never reallocates
+    reserve(drivers.size() + reader->estimateRows(32));
+
+    size_t added = 0;
+    while (reader->nextLine(line)) {
+        size_t count = CsvReader::splitFields(line, fields, columns);
+        if (count < columns) {
+            cerr << "Warning: Incomplete driver at line " << reader->lineNumber() << " in " << path << endl;
+            continue;
+        }
+
+        string_view idText = fields[idCol];
+        int id = 0;
+        auto parsed = from_chars(idText.data(), idText.data() + idText.size(), id);
+        if (parsed.ec != errc() || fields[nameCol].empty()) {
+            cerr << "Warning: Invalid driver at line " << reader->lineNumber() << " in " << path << endl;
+            continue;
+        }
+
+        double rating = 0;
+        if (ratingCol >= 0 && !parseDouble(fields[ratingCol], rating)) rating = 0;
+
+        string_view vehicle = (vehicleCol >= 0 && !fields[vehicleCol].empty())
+            ? fields[vehicleCol]
+            : string_view(ROAD_VEHICLES[added % ROAD_VEHICLE_COUNT]);
+
+        // Text stays a view into the mapped roster, which we keep open
+        if (!add(id, fields[nameCol], phoneCol >= 0 ? fields[phoneCol] : string_view(), vehicle,
+                 static_cast<float>(rating), plateCol >= 0 ? fields[plateCol] : string_view())) {
+            cerr << "Warning: Duplicate driver id " << id << " at line " << reader->lineNumber() << " in " << path << endl;
+            continue;
+        }
+        ++added;
+
+        double lat, lon;
+        if (latCol >= 0 && lonCol >= 0 && parseDouble(fields[latCol], lat) && parseDouble(fields[lonCol], lon)) {
+            Driver& driver = drivers.back();
+            driver.lat = lat;
+            driver.lon = lon;
+            driver.located = true;
+            located.insert(static_cast<uint32_t>(drivers.size() - 1), driver.vehicleId, lat, lon);
+        }
+    }
+    rosters.push_back(move(reader));
+    return added;
+}
+
+const Driver* DriverManager::findDriver(int driverId) const {
+    auto it = slotOf.find(driverId);
+    return (it != slotOf.end()) ? &drivers[it->second] : nullptr;
+}
+
+Driver* DriverManager::take(uint32_t slot) {
+    Driver& driver = drivers[slot];
+    driver.available = false;
+    // Invalidates the driver's queue entry, wherever it is
+    driver.queueTicket++;
+    freeCounts[driver.vehicleId]--;
+    located.remove(slot);
+    return &driver;
+}
+
+Driver* DriverManager::assignDriver(string_view vehicleType) {
+    int index = vehicleIndex(vehicleType);
+    if (index < 0 || freeCounts[index] == 0) {
+        return nullptr; // No available driver
+    }
+
+    auto& pool = freeByVehicle[index];
+    while (!pool.empty()) {
+        auto [slot, ticket] = pool.front();
+        pool.pop_front();
+        if (drivers[slot].available && drivers[slot].queueTicket == ticket) return take(slot);
+    }
+    return nullptr;
+}
+
+Driver* DriverManager::assignNearestDriver(string_view vehicleType, double lat, double lon, double* distanceKm) {
+    if (distanceKm) *distanceKm = -1;
+    int index = vehicleIndex(vehicleType);
+    if (index < 0 || freeCounts[index] == 0) {
+        return nullptr; // No available driver
+    }
+
+    uint32_t slot = located.nearest(static_cast<uint16_t>(index), lat, lon, distanceKm);
+    if (slot == DriverGrid::NOT_FOUND) return assignDriver(vehicleType);
+    return take(slot);
+}
+
+vector<const Driver*> DriverManager::nearestFreeDrivers(string_view vehicleType, double lat, double lon,
+                                                       size_t k) const {
+    vector<const Driver*> result;
+    int index = vehicleIndex(vehicleType);
+    if (index < 0) return result;
+
+    for (uint32_t slot : located.nearest(static_cast<uint16_t>(index), lat, lon, k)) {
+        result.push_back(&drivers[slot]);
+    }
+    return result;
+}
+
+Driver* DriverManager::claimDriver(int driverId) {
+    auto it = slotOf.find(driverId);
+    if (it == slotOf.end() || !drivers[it->second].available) return nullptr;
+    return take(it->second);
+}
+
+bool DriverManager::updateLocation(int driverId, double lat, double lon) {
+    auto it = slotOf.find(driverId);
+    if (it == slotOf.end()) return false;
+
+    Driver& driver = drivers[it->second];
+    driver.lat = lat;
+    driver.lon = lon;
+    driver.located = true;
+    if (!driver.available) return true;
+
+    if (located.contains(it->second)) located.move(it->second, lat, lon);
+    else located.insert(it->second, driver.vehicleId, lat, lon);
+    return true;
+}
+
+void DriverManager::releaseDriver(int driverId) {
+    auto it = slotOf.find(driverId);
+    if (it == slotOf.end()) return;
+
+    Driver& driver = drivers[it->second];
+    if (driver.available) return;
+    driver.available = true;
+    auto& pool = freeByVehicle[driver.vehicleId];
+    pool.push_back({it->second, driver.queueTicket});
+    freeCounts[driver.vehicleId]++;
+
+    // Drivers assigned by location leave stale entries behind; drop them
+    // once they outnumber the live ones, so the queue stays O(free drivers)
+    if (pool.size() > 2 * freeCounts[driver.vehicleId] + 16) {
+        auto live = remove_if(pool.begin(), pool.end(), [this](const pair<uint32_t, uint32_t>& entry) {
+            const Driver& queued = drivers[entry.first];
+            return !queued.available || queued.queueTicket != entry.second;
+        });
+        pool.erase(live, pool.end());
+    }
+    if (driver.located) located.insert(it->second, driver.vehicleId, driver.lat, driver.lon);
+}
+
+size_t DriverManager::availableCount(string_view vehicleType) const {
+    int index = vehicleIndex(vehicleType);
+    return (index >= 0) ? freeCounts[index] : 0;
+}
+
+void DriverManager::printAvailableDrivers() {
+    cout << "\nAvailable Drivers:\n";
+    cout << "--------------------------------------------------\n";
+    cout << "ID | Name            | Vehicle | Rating | Plate\n";
+    cout << "--------------------------------------------------\n";
+    for (const auto& driver : drivers) {
+        if (driver.available) {
+            cout << driver.id << " | " << driver.name << " | " << driver.vehicle << " | ";
+            if (driver.rating > 0) cout << fixed << setprecision(1) << driver.rating;
+            else cout << "-";
+            cout << " | " << (driver.plate.empty() ? "-" : driver.plate) << "\n";
+        }
+    }
+}
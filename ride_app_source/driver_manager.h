@@ -0,0 +1,125 @@
+#ifndef DRIVER_MANAGER_H
+#define DRIVER_MANAGER_H
+
+#include "csv_reader.h"
+#include "driver_grid.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Text fields are owned by the DriverManager: they point into the mapped
+// roster file, or into its own copies for drivers added one by one.
+struct Driver {
+    int id;
+    std::string_view name;
+    std::string_view phone;
+    std::string_view vehicle;
+    std::string_view plate;    // empty if unknown
+    float rating = 0;          // 0 to 5, 0 if unrated
+    uint16_t vehicleId = 0;    // index of the vehicle's free queue
+    bool available = true;
+    bool located = false;      // lat/lon hold a reported position
+    double lat = 0, lon = 0;
+    uint32_t queueTicket = 0;  // matches the driver's live free-queue entry
+};
+
+// The fleet, with a queue of free drivers per vehicle type and an index
+// from driver id to slot, so assigning and releasing a driver take the
+// same time for 7 drivers or a million. Free drivers are handed out in
+// the order they became free, or nearest first when the pickup is known:
+// free drivers with a position are also kept in a DriverGrid.
+class DriverManager {
+public:
+    DriverManager() = default;
+    DriverManager(const DriverManager&) = delete;
+    DriverManager& operator=(const DriverManager&) = delete;
+
+    // Room for count drivers, so adding them doesn't reallocate
+    void reserve(size_t count);
+
+    // Driver pointers stay valid until the next addDriver(). False, with
+    // nothing added, if another driver already has this id.
+    bool addDriver(int id, const std::string& name, const std::string& phone, const std::string& vehicle,
+                   float rating = 0, const std::string& plate = "");
+
+    // Add every driver in a roster CSV with columns rider_id, name, phone,
+    // rating and license_plate (any order, others ignored). A vehicle
+    // column is optional; without one drivers are spread evenly over the
+    // road vehicle types. Optional latitude and longitude columns give
+    // starting positions. The file stays mapped and is parsed in one pass.
+    // Rows repeating an earlier driver id are skipped with a warning.
+    // Returns the number of drivers added.
+    size_t loadFromCsv(const std::string& path);
+
+    // Getter for drivers
+    const std::vector<Driver>& getDrivers() const {
+        return drivers;
+    }
+
+    // The driver with this id, nullptr if there is none
+    const Driver* findDriver(int driverId) const;
+
+    // Take a free driver of this vehicle type, nullptr if none is free
+    Driver* assignDriver(std::string_view vehicleType);
+
+    // Take the free driver of this vehicle type closest to (lat, lon).
+    // Drivers without a position are only used if no located one is free.
+    // distanceKm gets the driver's distance, or -1 if it is unknown.
+    Driver* assignNearestDriver(std::string_view vehicleType, double lat, double lon,
+                                double* distanceKm = nullptr);
+
+    // Up to k free drivers of this vehicle type with a position, closest
+    // to (lat, lon) first. They stay free until claimed.
+    std::vector<const Driver*> nearestFreeDrivers(std::string_view vehicleType, double lat, double lon,
+                                                  size_t k) const;
+
+    // Take one particular free driver, nullptr if it is busy or unknown
+    Driver* claimDriver(int driverId);
+
+    // Record a driver's current position (false if the id is unknown)
+    bool updateLocation(int driverId, double lat, double lon);
+
+    // Put a driver back in its vehicle's queue (no-op if already free)
+    void releaseDriver(int driverId);
+
+    // Free drivers of one vehicle type
+    size_t availableCount(std::string_view vehicleType) const;
+
+    void printAvailableDrivers();
+
+private:
+    // Add a driver whose text already lives in storage we own; false if
+    // the id is taken
+    bool add(int id, std::string_view name, std::string_view phone, std::string_view vehicle,
+             float rating, std::string_view plate);
+    // Queue index for a vehicle type, registering it if new (or -1 if not)
+    int vehicleIndex(std::string_view vehicle) const;
+    uint16_t internVehicle(std::string_view vehicle);
+    // Stable copy of text added through addDriver()
+    std::string_view keep(const std::string& text);
+    // Mark a driver busy, taking it out of the grid
+    Driver* take(uint32_t slot);
+
+    std::vector<Driver> drivers;
+    // Driver id -> index into drivers
+    std::unordered_map<int, uint32_t> slotOf;
+    // Per vehicle type (a handful): its name and its free drivers, longest
+    // free first
+    // (slot, ticket); entries whose ticket is stale were assigned by
+    // location and are skipped when they reach the front
+    std::deque<std::string> vehicleNames;
+    std::vector<std::deque<std::pair<uint32_t, uint32_t>>> freeByVehicle;
+    std::vector<size_t> freeCounts;
+    // Free drivers with a position, one layer per vehicle type
+    DriverGrid located;
+    // Backing storage for the text in drivers
+    std::deque<std::string> ownedText;
+    std::vector<std::unique_ptr<CsvReader>> rosters;
+};
+
+#endif // DRIVER_MANAGER_H
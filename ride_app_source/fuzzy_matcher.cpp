@@ -0,0 +1,139 @@
+#include "fuzzy_matcher.h"
+#include <algorithm>
+
+using namespace std;
+
+static constexpr char PAD = '$';
+
+void FuzzyMatcher::trigramsOf(const string& key, vector<uint32_t>& out) {
+    out.clear();
+    if (key.empty()) return;
+
+    string padded = PAD + key + PAD;
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        out.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16) |
+                      (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8) |
+                       static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+FuzzyMatcher::FuzzyMatcher(const vector<City>& cities) : cities(cities) {
+    keys.reserve(cities.size());
+    for (const auto& city : cities) {
+        keys.push_back(normalizeName(city.name));
+    }
+
+    // Collect (trigram, id) pairs and sort them into posting lists
+    vector<pair<uint32_t, uint32_t>> pairs;
+    vector<uint32_t> grams;
+    for (uint32_t id = 0; id < keys.size(); ++id) {
+        trigramsOf(keys[id], grams);
+        for (uint32_t gram : grams) pairs.push_back({gram, id});
+    }
+    sort(pairs.begin(), pairs.end());
+
+    postingIds.reserve(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (i == 0 || pairs[i].first != pairs[i - 1].first) {
+            trigramList.push_back(pairs[i].first);
+            postingStart.push_back(static_cast<uint32_t>(i));
+        }
+        postingIds.push_back(pairs[i].second);
+    }
+    postingStart.push_back(static_cast<uint32_t>(pairs.size()));
+}
+
+vector<FuzzyMatcher::Match> FuzzyMatcher::suggest(const string& query, size_t k, int maxDistance) const {
+    vector<Match> results;
+    string key = normalizeName(query);
+    if (key.empty() || k == 0) return results;
+
+    int limit = (maxDistance >= 0) ? maxDistance : 1 + static_cast<int>(key.size()) / 4;
+
+    // Posting list of every query trigram present in the index, rarest first
+    struct Posting { uint32_t begin, end; };
+    vector<uint32_t> grams;
+    trigramsOf(key, grams);
+    vector<Posting> postings;
+    for (uint32_t gram : grams) {
+        auto it = lower_bound(trigramList.begin(), trigramList.end(), gram);
+        if (it == trigramList.end() || *it != gram) continue;
+        size_t slot = it - trigramList.begin();
+        postings.push_back({postingStart[slot], postingStart[slot + 1]});
+    }
+    sort(postings.begin(), postings.end(), [](const Posting& a, const Posting& b) {
+        return (a.end - a.begin) < (b.end - b.begin);
+    });
+
+    // Count shared trigrams per name. Very common trigrams ("sta", "ion")
+    // add little once a few rare ones have been seen, so they are skipped.
+    // The counts live in a buffer that stays zeroed between queries, so a
+    // query costs the names it touches, not the size of the catalog.
+    const size_t commonPosting = max<size_t>(256, keys.size() / 8);
+    static thread_local vector<uint16_t> shared;
+    if (shared.size() < keys.size()) shared.resize(keys.size(), 0);
+    vector<uint32_t> touched;
+    for (size_t i = 0; i < postings.size(); ++i) {
+        size_t length = postings[i].end - postings[i].begin;
+        if (i >= 3 && length > commonPosting) break;
+        for (uint32_t p = postings[i].begin; p < postings[i].end; ++p) {
+            uint32_t id = postingIds[p];
+            if (shared[id]++ == 0) touched.push_back(id);
+        }
+    }
+
+    // Only the best-overlapping names are worth an edit distance check
+    int keyLength = static_cast<int>(key.size());
+    vector<uint32_t> candidates;
+    for (uint32_t id : touched) {
+        if (abs(static_cast<int>(keys[id].size()) - keyLength) <= limit) candidates.push_back(id);
+    }
+    size_t shortlist = max<size_t>(64, k * 8);
+    if (candidates.size() > shortlist) {
+        nth_element(candidates.begin(), candidates.begin() + shortlist, candidates.end(),
+                    [&](uint32_t a, uint32_t b) { return shared[a] > shared[b]; });
+        candidates.resize(shortlist);
+    }
+    for (uint32_t id : touched) shared[id] = 0;
+
+    for (uint32_t id : candidates) {
+        int distance = editDistance(key, keys[id], limit);
+        if (distance <= limit) results.push_back({&cities[id], distance});
+    }
+
+    sort(results.begin(), results.end(), [](const Match& a, const Match& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return a.city->name < b.city->name;
+    });
+    if (results.size() > k) results.resize(k);
+    return results;
+}
+
+int editDistance(const string& a, const string& b, int limit) {
+    int n = static_cast<int>(a.size());
+    int m = static_cast<int>(b.size());
+    if (abs(n - m) > limit) return limit + 1;
+
+    // Three rolling rows: two back (for swaps), previous and current
+    vector<int> before(m + 1), previous(m + 1), current(m + 1);
+    for (int j = 0; j <= m; ++j) previous[j] = j;
+
+    for (int i = 1; i <= n; ++i) {
+        current[0] = i;
+        int rowBest = current[0];
+        for (int j = 1; j <= m; ++j) {
+            int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            current[j] = min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                current[j] = min(current[j], before[j - 2] + 1);
+            }
+            rowBest = min(rowBest, current[j]);
+        }
+        if (rowBest > limit) return limit + 1;
+        before.swap(previous);
+        previous.swap(current);
+    }
+    return min(previous[m], limit + 1);
+}
@@ -0,0 +1,40 @@
+#ifndef FUZZY_MATCHER_H
+#define FUZZY_MATCHER_H
+
+#include "distance_calculator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Typo-tolerant name lookup. A trigram index over normalized names picks
+// a short list of candidates, which are then ranked by edit distance.
+class FuzzyMatcher {
+public:
+    struct Match {
+        const City* city;
+        int distance;   // edits between the normalized query and name
+    };
+
+    explicit FuzzyMatcher(const std::vector<City>& cities);
+
+    // Up to k closest names, best first. Names needing more than
+    // maxDistance edits are dropped (-1 picks a limit from the query length).
+    std::vector<Match> suggest(const std::string& query, size_t k, int maxDistance = -1) const;
+
+private:
+    // Trigrams of a normalized key, padded so short names still get some
+    static void trigramsOf(const std::string& key, std::vector<uint32_t>& out);
+
+    const std::vector<City>& cities;
+    std::vector<std::string> keys;   // normalizeName() of each city
+    // Sorted (trigram, city id) pairs; ranges of equal trigram are postings
+    std::vector<uint32_t> postingStart;
+    std::vector<uint32_t> postingIds;
+    std::vector<uint32_t> trigramList;
+};
+
+// Optimal string alignment distance (insert, delete, substitute, swap
+// adjacent), giving up with limit + 1 once it cannot stay within limit.
+int editDistance(const std::string& a, const std::string& b, int limit);
+
+#endif // FUZZY_MATCHER_H
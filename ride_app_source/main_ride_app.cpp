@@ -1,11 +1,26 @@
 #include "distance_calculator.h"
+#include "city_catalog.h"
+#include "transit_router.h"
+#include "rail_lines.h"
+#include "driver_manager.h"
+#include "batch_dispatcher.h"
+#include "ride_store.h"
+#include "ride_journal.h"
+#include "ride_service.h"
+#include "command_mode.h"
+#include "ride_table.h"
+#include "ride_grouping.h"
 #include "calendar_picker.h"
+#include <fstream>
 #include <iostream>
 #include <list>
 #include <vector>
 #include <iomanip>
 #include <string>
-#include <windows.h> 
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 #include <limits>    
 #include <algorithm> 
 #include <cctype>    
@@ -23,128 +38,147 @@ using namespace std;
 
 
 
-struct person {
-    string ride_id; 
-    int num_of_persons;
-    string fname;
-    string lname;
-    string phone;
-    string pickup;
-    string dropoff;
-    int rideDay;
-    int rideMonth;
-    int rideYear;
-    string vehicle;
-    string status;
-    bool isCurrentRide = false;
-    double totalFare;
-    int assignedDriverId = -1; 
-
-    static const string Pending;
-    static const string Confirmed;
-    static const string Cancelled;
-    static const string Completed;
-    static const string OnRide;
-};
 
-const string person::OnRide = "OnRide";
+string toLower(const string& str) {
+    string result = str;
+    transform(result.begin(), result.end(), result.begin(), ::tolower);
+    return result;
+}
 
-struct Driver {
-    int id;
-    std::string name;
-    std::string phone;
-    std::string vehicle;
-    bool available;
+// Rides whose id is the input, then rides whose first name is (any case)
+vector<RideHandle> findRides(const RideStore& people, const string& input) {
+    vector<RideHandle> found;
+    RideHandle byId = people.findById(input);
+    if (byId.valid()) found.push_back(byId);
+    for (RideHandle handle : people.findByFirstName(input)) {
+        if (handle.index != byId.index) found.push_back(handle);
+    }
+    return found;
+}
 
-    Driver(int i, std::string n, std::string p, std::string v) 
-        : id(i), name(n), phone(p), vehicle(v), available(true) {}
-};
 
-class DriverManager {
-private:
-    std::vector<Driver> drivers;
+// Function Prototypes
+void booking(RideStore& people_list, DriverManager& dm);
+void searching(RideStore& people, DriverManager& dm);
+void clearScreen();
+void onride(RideStore& people_list, DriverManager& dm);
+void vehicle_type(VehicleType& vehicle);
+void Sedan();
+void view_all_rides(RideStore& people, DriverManager& dm);
+void current_ride_details(RideStore& people, DriverManager& dm);
+void editRides(RideStore& people, DriverManager& dm);
+void cancelRides(RideStore& people, DriverManager& dm);
+void deleteRides(RideStore& people, DriverManager& dm);
+void goingRides(RideStore& people, DriverManager& dm);
+int number_of_persons();
+void startRideWithAnimation(RideStore& people, DriverManager& dm);
+void dispatchPendingRides(RideStore& people, DriverManager& dm);
+bool isRideToday(const person& p);
 
-public:
-    void addDriver(int id, std::string name, std::string phone, std::string vehicle) {
-        drivers.emplace_back(id, name, phone, vehicle);
-    }
 
-    // Getter for drivers
-    const std::vector<Driver>& getDrivers() const {
-        return drivers;
-    }
 
-    Driver* assignDriver(const std::string& vehicleType) {
-        for (auto& driver : drivers) {
-            if (driver.available && driver.vehicle == vehicleType) {
-                driver.available = false;
-                return &driver;
-            }
-        }
-        return nullptr; // No available driver
+// Drivers from the roster next to the city files, or the built-in few,
+// each parked at a catalog place until it reports a position
+void loadDrivers(DriverManager& dm, ostream& log) {
+    auto loadStart = chrono::steady_clock::now();
+    string roster = CityCatalog::instance().dataDirectory() + "/drivers.csv";
+    size_t loaded = CityCatalog::instance().dataDirectory().empty() ? 0 : dm.loadFromCsv(roster);
+    if (loaded > 0) {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+        log << "Loaded " << loaded << " drivers in " << fixed << setprecision(2) << ms << " ms\n";
+    } else {
+        dm.addDriver(1, "Sergio Dela Cruz", "09409798726", "Sedan");
+        dm.addDriver(2, " Harold Salazar ", "09669458580", "SUV");
+        dm.addDriver(3, "Jerome Gonzales", "09403210927", "Sedan");
+        dm.addDriver(4, "Jessie Torres", "09547689400", "Truck");
+        dm.addDriver(5, "Wilson Roxas", "09387398460", "Van");
+        dm.addDriver(6, "Victor Fernandez", "09547689400", "Motorcycle");
+        dm.addDriver(7, "Arnold Aguilar", "09483490869", "Bus");
     }
 
-    void releaseDriver(int driverId) {
-        for (auto& driver : drivers) {
-            if (driver.id == driverId) {
-                driver.available = true;
-                break;
-            }
+    const auto& places = CityCatalog::instance().cities();
+    if (!places.empty()) {
+        for (size_t i = 0; i < dm.getDrivers().size(); ++i) {
+            const Driver& driver = dm.getDrivers()[i];
+            if (driver.located) continue;
+            const City& spot = places[(i * 2654435761u) % places.size()];
+            dm.updateLocation(driver.id, spot.lat, spot.lon);
         }
     }
+}
 
-    void printAvailableDrivers() {
-        std::cout << "\nAvailable Drivers:\n";
-        std::cout << "------------------------------\n";
-        std::cout << "ID | Name            | Vehicle\n";
-        std::cout << "------------------------------\n";
-        for (const auto& driver : drivers) {
-            if (driver.available) {
-                std::cout << driver.id << " | " << driver.name << " | " << driver.vehicle << "\n";
-            }
-        }
+// Bring back the rides from earlier runs, and the drivers they hold, and
+// journal every change from here on. False if the saved rides cannot be
+// loaded or journaling cannot start.
+bool restoreRides(RideJournal& journal, RideStore& people, DriverManager& dm, ostream& log) {
+    const string& dataDir = CityCatalog::instance().dataDirectory();
+    string journalBase = dataDir.empty() ? "rides" : dataDir + "/rides";
+    auto replayStart = chrono::steady_clock::now();
+    if (!journal.open(journalBase, people)) {
+        // Running on would hide the saved rides and save nothing new
+        cerr << "Error: Could not load the saved rides in " << journalBase << ".snapshot and "
+             << journalBase << "-*.journal, or start a new journal there. Nothing was changed;"
+             << " repair or move those files and start again." << endl;
+        return false;
     }
-};
 
-string toLower(const string& str) {
-    string result = str;
-    transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+    for (const auto& p : people) {
+        bool active = p.status == RideStatus::Pending || p.status == RideStatus::Confirmed ||
+                      p.status == RideStatus::OnRide;
+        if (active && p.assignedDriverId != -1) dm.claimDriver(p.assignedDriverId);
+    }
+    if (people.size() > 0 || journal.replayedCount() > 0) {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - replayStart).count();
+        log << "Restored " << people.size() << " rides (" << journal.restoredCount() << " from the snapshot, "
+            << journal.replayedCount() << " journal records after it) in " << fixed << setprecision(2)
+            << ms << " ms\n";
+    }
+    people.attach(&journal);
+    return true;
 }
 
+// --headless [file]: run commands from the file, or stdin, and print one
+// JSON result per command instead of showing the menus
+int runHeadless(RideStore& people, DriverManager& dm, RideJournal& journal, const char* path) {
+    ifstream file;
+    if (path) {
+        file.open(path);
+        if (!file) {
+            cerr << "Error: Could not open command file " << path << endl;
+            return 1;
+        }
+    }
+    istream& in = path ? static_cast<istream&>(file) : cin;
+
+    RideService service(people, dm);
+    CommandMode commands(service, journal.isOpen() ? &journal : nullptr);
+    auto start = chrono::steady_clock::now();
+    size_t failed = commands.run(in, cout);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cerr << "Ran " << commands.commandCount() << " commands (" << failed << " failed) in " << fixed
+         << setprecision(2) << ms << " ms, " << setprecision(0)
+         << commands.commandCount() / max(ms / 1000.0, 1e-9) << " per second\n";
+    return failed == 0 ? 0 : 2;
+}
 
-// Function Prototypes
-void booking(list<struct person>& people_list, DriverManager& dm);
-void searching(list<struct person>& people, DriverManager& dm);
-void clearScreen();
-void onride(list<struct person>& people_list, DriverManager& dm);
-void vehicle_type(string& vehicle);
-void Sedan();
-void view_all_rides(list<struct person>& people, DriverManager& dm);
-void current_ride_details(list<person>& people, DriverManager& dm);
-void editRides(list<struct person>& people, DriverManager& dm);
-void cancelRides(list<struct person>& people, DriverManager& dm);
-void deleteRides(list<struct person>& people, DriverManager& dm);
-void goingRides(list<struct person>& people, DriverManager& dm);
-int number_of_persons();
-int countDuplicateVectors(const list<vector<string>>& data);
-void startRideWithAnimation(list<person>& people, DriverManager& dm);
-
-
-
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
-    list<struct person> people;
+    RideStore people;
     DriverManager dm; 
+    bool headless = argc > 1 && strcmp(argv[1], "--headless") == 0;
+    // Keep standard output for the results when headless
+    ostream& log = headless ? cerr : cout;
+    if (headless) ios::sync_with_stdio(false);
+
+    // Parse the city catalog once, up front, instead of on every booking.
+    // The distance table waits for the first fare quote.
+    CityCatalog::instance();
     
-    // Initialize drivers
-    dm.addDriver(1, "Sergio Dela Cruz", "09409798726", "Sedan");
-    dm.addDriver(2, " Harold Salazar ", "09669458580", "SUV");
-    dm.addDriver(3, "Jerome Gonzales", "09403210927", "Sedan");
-    dm.addDriver(4, "Jessie Torres", "09547689400", "Truck");
-    dm.addDriver(5, "Wilson Roxas", "09387398460", "Van");
-    dm.addDriver(6, "Victor Fernandez", "09547689400", "Motorcycle");
-    dm.addDriver(7, "Arnold Aguilar", "09483490869", "Bus");
+    loadDrivers(dm, log);
+    RideJournal journal;
+    if (!restoreRides(journal, people, dm, log)) return 1;
+
+    if (headless) return runHeadless(people, dm, journal, argc > 2 ? argv[2] : nullptr);
     
     do {
         clearScreen();
@@ -159,6 +193,7 @@ int main() {
         cout << "5. Search for a ride\n";
         cout << "6. Cancel a ride\n";
         cout << "7. View available drivers\n"; 
+        cout << "8. Dispatch today's pending rides\n";
         cout << "0. Exit\n";
         cout << "Please enter your choice: ";
         
@@ -198,6 +233,10 @@ int main() {
                 clearScreen();
                 dm.printAvailableDrivers();
                 break;
+            case 8:
+                clearScreen();
+                dispatchPendingRides(people, dm);
+                break;
             case 0:
                 cout << "\n\n";
                 cout << "=========================================================\n";
@@ -210,6 +249,11 @@ int main() {
             default:
                 cout << "Invalid choice. Please try again.\n";
         }
+
+        // Everything the action changed is on disk before the next prompt
+        if (!journal.waitDurable()) {
+            cout << "\nWarning: Changes could not be saved to disk and will be lost on exit.\n";
+        }
         
         if (choice != 0) {
             cout << "\nPress Enter to continue...";
@@ -222,6 +266,7 @@ int main() {
 }
 
 void clearScreen() {
+#ifdef _WIN32
     HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
     COORD coord = {0, 0};
     DWORD count;
@@ -230,6 +275,9 @@ void clearScreen() {
     GetConsoleScreenBufferInfo(hStdout, &csbi);
     FillConsoleOutputCharacter(hStdout, ' ', csbi.dwSize.X * csbi.dwSize.Y, coord, &count);
     SetConsoleCursorPosition(hStdout, coord);
+#else
+    cout << "\033[2J\033[1;1H" << flush;
+#endif
 }
 
 
@@ -237,7 +285,7 @@ void clearScreen() {
 int groupRideCount = 0;
 
 
-void onride(list<struct person>& people_list, DriverManager& dm) {
+void onride(RideStore& people_list, DriverManager& dm) {
     clearScreen();
 
     
@@ -246,15 +294,9 @@ void onride(list<struct person>& people_list, DriverManager& dm) {
         return;
     }
 
-    map<tuple<string, int, int, int, string, string>, vector<person*>> groupedRides;
-    for (auto& p : people_list) {
-        if (p.status == "OnRide" || p.status == "Confirmed" || p.status == "Pending") {
-            auto key = make_tuple(p.vehicle, p.rideDay, p.rideMonth, p.rideYear, p.pickup, p.dropoff);
-            groupedRides[key].push_back(&p);
-        }
-    }
+    RideGroups groupedRides(people_list, {RideStatus::OnRide, RideStatus::Confirmed, RideStatus::Pending});
 
-    if (groupedRides.empty()) {
+    if (groupedRides.size() == 0) {
         cout << "No active rides.\n";
         cout << "\nPress Enter to return...";
         cin.ignore(); cin.get();
@@ -262,25 +304,23 @@ void onride(list<struct person>& people_list, DriverManager& dm) {
     }
 
     vector<string> rideDetails; // list of rideDetails
+    const vector<City>& places = CityCatalog::instance().cities();
     
 
-    for (const auto& group : groupedRides) {
-        const auto& [vehicle, day, month, year, pickup, dropoff] = group.first;
-        const auto& riders = group.second;
+    for (const auto& group : groupedRides.groups()) {
+        const person* const* riders = groupedRides.ridersOf(group);
 
         stringstream ss;
         ss << "\n=== RIDE DETAILS ===\n"
-           << "Vehicle: " << vehicle << "\n"
-           << "Date: " << month << "/" << day << "/" << year << "\n"
-           << "Route: " << pickup << " -> " << dropoff << "\n";
+           << "Vehicle: " << group.key.vehicle << "\n"
+           << "Date: " << riders[0]->rideMonth << "/" << riders[0]->rideDay << "/" << riders[0]->rideYear << "\n"
+           << "Route: " << places[group.key.pickup].name << " -> " << places[group.key.dropoff].name << "\n";
 
         
         if (riders[0]->assignedDriverId != -1) {
-            for (const auto& driver : dm.getDrivers()) {
-                if (driver.id == riders[0]->assignedDriverId) {
-                    ss << "Driver: " << driver.name << " (Contact: " << driver.phone << ")\n";
-                    break;
-                }
+            const Driver* driver = dm.findDriver(riders[0]->assignedDriverId);
+            if (driver) {
+                ss << "Driver: " << driver->name << " (Contact: " << driver->phone << ")\n";
             }
         }
         rideDetails.push_back(ss.str()); 
@@ -314,9 +354,8 @@ void onride(list<struct person>& people_list, DriverManager& dm) {
 }
 
 
-void vehicle_type(string& vehicle) {
+void vehicle_type(VehicleType& vehicle) {
     int choice;
-    vehicle = "";
 
     cout << "\nPlease select the vehicle type: \n";
     cout << "1. Sedan\n";
@@ -334,15 +373,8 @@ void vehicle_type(string& vehicle) {
         cout << "Invalid choice. Please enter a number between 1-7: ";
     }
 
-    switch (choice) {
-        case 1: vehicle = "Sedan"; break;
-        case 2: vehicle = "SUV"; break;
-        case 3: vehicle = "Truck"; break;
-        case 4: vehicle = "Van"; break;
-        case 5: vehicle = "Motorcycle"; break;
-        case 6: vehicle = "Bus"; break;
-        case 7: vehicle = "Train"; break;
-    }
+    // Menu order matches VehicleType
+    vehicle = static_cast<VehicleType>(choice - 1);
 }
 
 void Sedan() {
@@ -350,7 +382,7 @@ void Sedan() {
     cout << "Please wait...\n";
 }
 
-void searching(list<struct person>& people, DriverManager& dm) {
+void searching(RideStore& people, DriverManager& dm) {
     string fname, lname;
 
     cin.ignore(numeric_limits<streamsize>::max(), '\n'); // Clear input buffer
@@ -360,14 +392,15 @@ void searching(list<struct person>& people, DriverManager& dm) {
     getline(cin, lname);
 
     bool found = false;
-    for (auto& p : people) {
-        if (toLower(p.fname) == toLower(fname) && toLower(p.lname) == toLower(lname) && p.status == "Pending") {
+    for (RideHandle handle : people.findByName(fname, lname)) {
+        const person& p = *people.get(handle);
+        if (p.status == RideStatus::Pending) {
             found = true;
 
             cout << "\nRide details for " << p.fname << " " << p.lname << ":\n";
             cout << "Phone Number: " << p.phone << "\n";
-            cout << "Pickup Location: " << p.pickup << "\n";
-            cout << "Dropoff Location: " << p.dropoff << "\n";
+            cout << "Pickup Location: " << p.pickupCity().name << "\n";
+            cout << "Dropoff Location: " << p.dropoffCity().name << "\n";
             cout << "Date of Ride: " << p.rideYear << "-" 
                  << setw(2) << setfill('0') << p.rideMonth << "-" 
                  << setw(2) << setfill('0') << p.rideDay << "\n";
@@ -381,9 +414,11 @@ void searching(list<struct person>& people, DriverManager& dm) {
             cin >> choice;
 
             if (toupper(choice) == 'Y') {
-                p.status = "Pending";  // Update status
+                people.update(handle, [](person& ride) {
+                    ride.status = RideStatus::Pending;  // Update status
+                    ride.isCurrentRide = true;
+                });
                 cout << "Ride is confirmed.\n";
-                p.isCurrentRide = true;
                 current_ride_details(people, dm);
             } else {
                 cout << "Ride is cancelled.\n";
@@ -412,9 +447,10 @@ int number_of_persons() {
     return num;
 }
 
-void booking(list<struct person>& people, DriverManager& dm) {
+void booking(RideStore& people, DriverManager& dm) {
     DistanceCalculator calculator;
-    auto cities = calculator.loadAllCities();
+    RideService service(people, dm);
+    const CityCatalog& cities = CityCatalog::instance();
 
     cout << "========= BOOKING RIDE MODE =========\n";
     
@@ -444,7 +480,7 @@ void booking(list<struct person>& people, DriverManager& dm) {
         struct person p;
 
         
-        p.ride_id = to_string(static_cast<long long>(time(nullptr))) + "_" + to_string(i);
+        p.ride_id = RideService::newRideId();
 
         cout << "\nBooking for person " << (i + 1) << ":\n";
         cout << "\nACCOUNT DETAILS:\n\n";
@@ -462,8 +498,8 @@ void booking(list<struct person>& people, DriverManager& dm) {
         cout << "\nLOCATION DETAILS:";
 
         auto [fromCity, toCity] = calculator.selectLocations(cities);
-        string from = fromCity->name;
-        string to = toCity->name;
+        string from(fromCity->name);
+        string to(toCity->name);
         
         
         double distance = calculator.calculateDistance(*fromCity, *toCity);
@@ -478,31 +514,49 @@ void booking(list<struct person>& people, DriverManager& dm) {
 
 
 
-        p.pickup = from;
-        p.dropoff = to;
+        p.pickup = cities.idOf(*fromCity);
+        p.dropoff = cities.idOf(*toCity);
 
         // Select vehicle type
         vehicle_type(p.vehicle);
+
+        if (p.vehicle == VehicleType::Train) {
+            cout << "\n";
+            calculator.showNearestStations(cities, *fromCity);
+            calculator.showNearestStations(cities, *toCity);
+        }
+        if (p.vehicle == VehicleType::Train || p.vehicle == VehicleType::Bus) {
+            cout << "\n";
+            calculator.showTransitRoute(TransitRouter::instance(), *fromCity, *toCity);
+        }
         
-        // Assign a driver
-        Driver* assignedDriver = dm.assignDriver(p.vehicle);
+        // Assign the nearest free driver to the pickup
+        double driverKm;
+        Driver* assignedDriver = service.assignDriver(p, &driverKm);
         if (assignedDriver) {
             cout << "\nAssigned Driver: " << assignedDriver->name 
                  << " (" << assignedDriver->phone << ")\n";
-            p.assignedDriverId = assignedDriver->id;
+            if (driverKm >= 0) {
+                cout << "Driver is " << fixed << setprecision(2) << driverKm << " km from " << from << "\n";
+            }
+            if (!assignedDriver->plate.empty()) {
+                cout << "Plate: " << assignedDriver->plate << ", rating "
+                     << fixed << setprecision(1) << assignedDriver->rating << "\n";
+            }
         } else {
             cout << "\nNo available drivers for " << p.vehicle << " at the moment.\n";
-            p.assignedDriverId = -1; // No driver assigned
         }
 
         cout << "\nPlease select the date for your ride:\n";
-        selectDate(p.rideMonth, p.rideYear, p.rideDay);
+        int rideMonth, rideYear, rideDay;
+        selectDate(rideMonth, rideYear, rideDay);
+        p.setDate(rideDay, rideMonth, rideYear);
 
-        p.status = "Pending";
-        p.num_of_persons = num_persons;
+        p.status = RideStatus::Pending;
+        p.num_of_persons = static_cast<uint16_t>(num_persons);
         p.isCurrentRide = true;
 
-        people.push_back(p);
+        people.add(p);
 
         cout << "\nYour ride has been successfully booked for "
              << p.fname << " " << p.lname << ".\n";
@@ -526,22 +580,22 @@ void booking(list<struct person>& people, DriverManager& dm) {
     if (toupper(choice) == 'Y') {
         current_ride_details(people, dm);
     } else {
-        for (auto& p : people) {
+        for (const auto& p : people) {
             if (p.isCurrentRide) {
                 if (p.assignedDriverId != -1) {
                     dm.releaseDriver(p.assignedDriverId);
                 }
-                p.isCurrentRide = false;
-                p.status = "Pending";
+                people.update(people.handleOf(p), [](person& ride) {
+                    ride.isCurrentRide = false;
+                    ride.status = RideStatus::Pending;
+                });
                 cout << "\nRide has been Pending for " << p.fname << " " << p.lname;
             }
         }
     }
 }
 
-void current_ride_details(list<person>& people, DriverManager& dm) {
-    DistanceCalculator calculator;
-    auto cities = calculator.loadAllCities();
+void current_ride_details(RideStore& people, DriverManager& dm) {
 
     vector<string> tempVehicles;
     std::list<std::vector<std::string>> allVehicles;
@@ -557,8 +611,8 @@ void current_ride_details(list<person>& people, DriverManager& dm) {
             cout << "Ride #" << index++ << ":\n";
             cout << "Name: " << p.fname << " " << p.lname << endl;
             cout << "Phone: " << p.phone << endl;
-            cout << "Pickup: " << p.pickup << endl;
-            cout << "Dropoff: " << p.dropoff << endl;
+            cout << "Pickup: " << p.pickupCity().name << endl;
+            cout << "Dropoff: " << p.dropoffCity().name << endl;
             cout << "Date: " << setw(2) << setfill('0') << p.rideMonth
                 << "/" << setw(2) << p.rideDay << "/" << p.rideYear << endl;
             cout << "Vehicle: " << p.vehicle << endl;
@@ -566,41 +620,25 @@ void current_ride_details(list<person>& people, DriverManager& dm) {
                 cout << "Driver ID: " << p.assignedDriverId << endl;
             }
             cout << "Status: " << p.status << "\n";
-            tempVehicles.push_back(p.vehicle);
+            tempVehicles.push_back(vehicleName(p.vehicle));
 
             // Calculate fare for selected vehicle
-            auto fromCityIt = cities.find(p.pickup);
-            auto toCityIt = cities.find(p.dropoff);
-
-            if (fromCityIt != cities.end() && toCityIt != cities.end()) {
-                const City& fromCity = fromCityIt->second;
-                const City& toCity = toCityIt->second;
-                double distance = calculator.calculateDistance(fromCity, toCity);
-
-                if (!DistanceCalculator::VEHICLE_RATES.count(p.vehicle)) {
-                    cerr << "Unknown vehicle type: " << p.vehicle << endl;
-                } else {
-                    auto rate = DistanceCalculator::VEHICLE_RATES.at(p.vehicle);
-                    double fare = rate.baseFare + (rate.perKmRate * distance);
-                    totalFare += fare;  // Add to total fare
-
-                    cout << fixed << setprecision(2);
-                    cout << "Base fare: " << DistanceCalculator::PESO_SIGN << rate.baseFare << endl;
-                    cout << "Per km rate: " << DistanceCalculator::PESO_SIGN << rate.perKmRate << endl;
-                    cout << "Distance: " << distance << " km" << endl;
-                    cout << "___________________" << endl;
-                    cout << "Ride fare: " << DistanceCalculator::PESO_SIGN << fare << endl;
-                    cout << "___________________" << endl;
-
-                    p.totalFare = fare;
-                }
+            double distance, fare;
+            if (!RideService::quoteFare(p, distance, fare)) {
+                cerr << "Unknown vehicle type: " << p.vehicle << endl;
             } else {
-                if (fromCityIt == cities.end()) {
-                    cerr << "Could not find pickup location: " << p.pickup << endl;
-                }
-                if (toCityIt == cities.end()) {
-                    cerr << "Could not find dropoff location: " << p.dropoff << endl;
-                }
+                const VehicleRate& rate = *RideService::rateFor(p.vehicle);
+                totalFare += fare;  // Add to total fare
+
+                cout << fixed << setprecision(2);
+                cout << "Base fare: " << DistanceCalculator::PESO_SIGN << rate.baseFare << endl;
+                cout << "Per km rate: " << DistanceCalculator::PESO_SIGN << rate.perKmRate << endl;
+                cout << "Distance: " << distance << " km" << endl;
+                cout << "___________________" << endl;
+                cout << "Ride fare: " << DistanceCalculator::PESO_SIGN << fare << endl;
+                cout << "___________________" << endl;
+
+                people.update(people.handleOf(p), [fare](person& ride) { ride.totalFare = fare; });
             }
         }
     }
@@ -609,7 +647,7 @@ void current_ride_details(list<person>& people, DriverManager& dm) {
     allVehicles.push_back(tempVehicles);
     tempVehicles.clear();
     
-    int total = countDuplicateVectors(allVehicles);
+    int total = countDuplicateVectors(allVehicles, cout);
          
     cout << fixed << setprecision(2);
     cout << "========================" << endl;
@@ -631,277 +669,63 @@ void current_ride_details(list<person>& people, DriverManager& dm) {
 
     if (toupper(choice) == 'Y') {
         cout << "Ride is confirmed.\n";
-        for (auto& ride : people) {
-            if (ride.isCurrentRide) {
-                ride.isCurrentRide = false;
-                ride.status = "Confirmed";
+        for (const auto& p : people) {
+            if (p.isCurrentRide) {
+                people.update(people.handleOf(p), [](person& ride) {
+                    ride.isCurrentRide = false;
+                    ride.status = RideStatus::Confirmed;
+                });
             }
         }
         onride(people, dm);
     } else {
-        for (auto& p : people) {
+        for (const auto& p : people) {
             if (p.isCurrentRide) {
                 if (p.assignedDriverId != -1) {
                     dm.releaseDriver(p.assignedDriverId);
                 }
-                p.isCurrentRide = false;
-                p.status = "Cancelled";
+                people.update(people.handleOf(p), [](person& ride) {
+                    ride.isCurrentRide = false;
+                    ride.status = RideStatus::Canceled;
+                });
             }
         }
         cout << "Ride is cancelled.\n";
     }
 }
 
-int countDuplicateVectors(const list<vector<string>>& data) {
-    if (data.size() < 2) return 0; 
-    
-    // Convert to vector for easier indexing
-    vector<vector<string>> temp(data.begin(), data.end());
-    int duplicateTotal = 0;
-    
-    // Track which vectors we've already counted
-    vector<bool> counted(temp.size(), false);
-    
-    for (size_t i = 0; i < temp.size(); ++i) {
-        if (counted[i]) continue; // Skip already counted vectors
-        
-        int currentGroupCount = 1; // Count self
-        
-        for (size_t j = i + 1; j < temp.size(); ++j) {
-            if (!counted[j] && temp[i] == temp[j]) {
-                currentGroupCount++;
-                counted[j] = true;
-            }
-        }
-        
-        if (currentGroupCount > 1) {
-            duplicateTotal += (currentGroupCount - 1); // Count extras beyond first
-            cout << "Found " << currentGroupCount << " copies of: ";
-            for (const auto& val : temp[i]) cout << val << " ";
-            cout << endl;
-        }
-    }
-    
-    return duplicateTotal;
-}
-
-void view_all_rides(list<struct person>& people, DriverManager& dm) {
+void view_all_rides(RideStore& people, DriverManager& dm) {
     if (people.empty()) {
         cout << "No rides booked yet.\n";
         return;
     }
 
-    string ride_id = "Ride ID";
-    string first_name = "First Name";
-    string last_name = "Last Name";
-    string phone_number = "Phone Number";
-    string pickup_location = "Pickup Location";
-    string dropoff_location = "Dropoff Location";
-    string date_of_ride = "Date of Ride";
-    string vehicle_type = "Vehicle Type";
-    string status = "Status";
-    string driver_id = "Driver ID";
-
-    int ride_id_len = ride_id.length();
-    int first_name_len = first_name.length();
-    int last_name_len = last_name.length();
-    int phone_number_len = phone_number.length();
-    int pickup_location_len = pickup_location.length();
-    int dropoff_location_len = dropoff_location.length();
-    int date_of_ride_len = date_of_ride.length();
-    int vehicle_type_len = vehicle_type.length();
-    int status_len = status.length();
-
-
-    // Finding the longest string in the list
-    int max_fname_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.fname.size() < b.fname.size();
-    })->fname.size();
-    int max_lname_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.lname.size() < b.lname.size();
-    })->lname.size();
-    int max_phone_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.phone.size() < b.phone.size();
-    })->phone.size();
-    int max_pickup_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.pickup.size() < b.pickup.size();
-    })->pickup.size();
-    int max_dropoff_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.dropoff.size() < b.dropoff.size();
-    })->dropoff.size();
-    int max_date_len =  10; // 10 for the date format "YYYY-MM-DD"
-    int max_vehicle_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.vehicle.size() < b.vehicle.size();
-    })->vehicle.size();
-    int max_status_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.status.size() < b.status.size();
-    })->status.size();
-    int max_ride_id_len = max_element(people.begin(), people.end(), [](const person& a, const person& b) {
-        return a.ride_id.size() < b.ride_id.size();
-    })->ride_id.size();
-
-
-    // Calculate new lengths for each column
-
-    int new_fname_len = max(max_fname_len, first_name_len);
-    int new_lname_len = max(max_lname_len, last_name_len);
-    int new_phone_len = max(max_phone_len, phone_number_len);
-    int new_pickup_len = max(max_pickup_len, pickup_location_len);
-    int new_dropoff_len = max(max_dropoff_len, dropoff_location_len);
-    int new_date_len = max(max_date_len, date_of_ride_len);
-    int new_vehicle_len = max(max_vehicle_len, vehicle_type_len);
-    int new_status_len = max(max_status_len, status_len);
-    int new_ride_id_len = max(max_ride_id_len, ride_id_len);
-
-    
-    // print border
-
-    string up_border = string(new_ride_id_len + new_fname_len + new_lname_len + new_phone_len + 
-                           new_pickup_len + new_dropoff_len + new_date_len + 
-                           new_vehicle_len + new_status_len + 18, '=');
-    string low_border = string(new_ride_id_len + new_fname_len + new_lname_len + new_phone_len + 
-                           new_pickup_len + new_dropoff_len + new_date_len + 
-                           new_vehicle_len + new_status_len + 18, '=');
-
-
-
-    int up_border_len = up_border.length();
-    string up_border_divided = up_border.substr(0, (up_border_len - 25) / 2);
-    string up_space = string((up_border_len - 25) / 2, ' ');
-    string dash = string(25, '-');
-
-    //print Table Ttle
-
-
-    cout << up_space << dash << up_space << "\n";
-    cout << up_space << "| RIDE MANAGEMENT TABLE |"<< up_space << "\n";
-    cout << up_space << dash << up_space << "\n";
-
-
-    
-    cout << "" << up_border << "\n";
-    
-    for (int space = 0; space < new_ride_id_len - ride_id_len + 1; space++) cout << " ";
-    cout << ride_id << "|";
-    for (int space = 0; space < new_fname_len - first_name_len + 1; space++) cout << " ";
-    cout << first_name << "|";
-    for (int space = 0; space < new_lname_len - last_name_len + 1; space++) cout << " ";
-    cout << last_name << "|";
-    for (int space = 0; space < new_phone_len - phone_number_len + 1; space++) cout << " ";
-    cout << phone_number << "|";
-    for (int space = 0; space < new_pickup_len - pickup_location_len + 1; space++) cout << " ";
-    cout << pickup_location << "|";
-    for (int space = 0; space < new_dropoff_len - dropoff_location_len + 1; space++) cout << " ";
-    cout << dropoff_location << "|";
-    for (int space = 0; space < new_date_len - date_of_ride_len + 1; space++) cout << " ";
-    cout << date_of_ride << "|";
-    for (int space = 0; space < new_vehicle_len - vehicle_type_len + 1; space++) cout << " ";
-    cout << vehicle_type << "|";
-    for (int space = 0; space < new_status_len - status_len + 1; space++) cout << " ";
-    cout << status << "|\n";
-
-
-
-    cout << up_border << "\n";
-
-    for (const auto& p : people) 
-    {
-        {
-            int number = p.ride_id.size();
-            for (int space = 0; space < new_ride_id_len - number; space++) {
-                cout << " ";
-            }
-            cout << " " << p.ride_id << "|";
-        }
-
-        {
-            int fname = p.fname.size();
-            for (int space = 0; space < new_fname_len - fname + 1; space++) {
-                cout << " ";
-            }
-            cout << p.fname << "|";
-        }
-
-        {
-            int lname = p.lname.size();
-            for (int space = 0; space < new_lname_len - lname + 1; space++) {
-                cout << " ";
-            }
-            cout << p.lname << "|";
-        }
-
-        {
-            int phone = p.phone.size();
-            for (int space = 0; space < new_phone_len - phone + 1; space++) {
-                cout << " ";
-            }
-            cout << p.phone << "|";
-        }
-
-        {
-            int pickup = p.pickup.size();
-            for (int space = 0; space < new_pickup_len - pickup + 1; space++) {
-                cout << " ";
-            }
-            cout << p.pickup << "|";
-        }
-
-        {
-            int dropoff = p.dropoff.size();
-            for (int space = 0; space < new_dropoff_len - dropoff + 1; space++) {
-                cout << " ";
-            }
-            cout << p.dropoff << "|";
-        }
-
-        {
-            stringstream date_ss;
-            date_ss << p.rideYear << "-"
-                    << setw(2) << setfill('0') << p.rideMonth << "-"
-                    << setw(2) << setfill('0') << p.rideDay;
-            string date = date_ss.str();
-            int date_len = date.size();
-            for (int space = 0; space < new_date_len - date_len + 1; space++) {
-                cout << " ";
-            }
-            cout << date << "|";
+    RideTable table(people);
+    size_t pages = table.pageCount();
+    size_t page = 0;
+    int choice;
+    while (true) {
+        table.printPage(cout, page);
+
+        cout << "--------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t\n";
+        cout << "| Press 1: To Edit |" << "\t\t" << "| Press 2: To Delete |" << "\t\t" << "|  Press 3: To Ride  |" << "\t\t" << "| Press 4: To Cancel |" << "\t\t\n";
+        cout << "--------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t\n";
+        if (pages > 1) {
+            cout << "| Press 5: Next Page |" << "\t\t" << "| Press 6: Previous Page |" << "\n";
         }
 
-        {
-            int vehicle = p.vehicle.size();
-            for (int space = 0; space < new_vehicle_len - vehicle + 1; space++) {
-                cout << " ";
-            }
-            cout << p.vehicle << "|";
-        }
+        cout << "\n\nPlease enter your choice here or press 0 to Menu: ";
+        cin >> choice;
 
-        {
-            int status = p.status.size();
-            for (int space = 0; space < new_status_len - status + 1; space++) {
-                cout << " ";
-            }
-            cout << p.status << "|";
+        if (pages > 1 && (choice == 5 || choice == 6)) {
+            if (choice == 5 && page + 1 < pages) page++;
+            if (choice == 6 && page > 0) page--;
+            clearScreen();
+            continue;
         }
-        std::cout << endl;
-
+        break;
     }
 
-    
-    cout << low_border << "\n";
-    cout << "\nTotal rides: " << people.size() << "\n\n";
-
-
-
-    cout << "--------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t\n";
-    cout << "| Press 1: To Edit |" << "\t\t" << "| Press 2: To Delete |" << "\t\t" << "|  Press 3: To Ride  |" << "\t\t" << "| Press 4: To Cancel |" << "\t\t\n";
-    cout << "--------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t" << "----------------------" << "\t\t\n";
-
-    cout << "\n\nPlease enter your choice here or press 0 to Menu: ";
-    int choice;
-    cin >> choice;
-
-
-
     if (choice == 0) {
         cout << "\nExiting to Main Menu... \n";
         return;
@@ -949,31 +773,27 @@ string toTitleCase(const string& str) {
 }
 
 
-void editRides(list<struct person>& people, DriverManager& dm) {
+void editRides(RideStore& people, DriverManager& dm) {
 
     string user_input;
     string full_name;
     string full_name_title;
     int choice, rideMonth, rideYear, rideDay;
     string phone_number;
-    string drop_off;
-    string pick_up;
+    DistanceCalculator calculator;
+    RideService service(people, dm);
+    const CityCatalog& cities = CityCatalog::instance();
     int totalChanges = 0;
 
     
-    int pendingCount = count_if(people.begin(), people.end(),
-        [](const person& p) {
-            return p.status == "Pending" || p.status == "pending";
-        });
+    int pendingCount = static_cast<int>(people.countWithStatus(RideStatus::Pending));
 
 
     cout << "\n====== EDITING MODE ======";
     cout << "\nPending Status Verification...";
 
 
-    bool anyPending = any_of(people.begin(), people.end(), 
-            [] (const person& p) {  
-                return p.status == "Pending" || p.status == "pending";});
+    bool anyPending = pendingCount > 0;
 
 
     if (!anyPending) {
@@ -992,9 +812,10 @@ void editRides(list<struct person>& people, DriverManager& dm) {
     
     bool ride_found = false;
 
-    for (auto& p: people){
+    for (RideHandle handle : findRides(people, user_input)) {
+        const person& p = *people.get(handle);
 
-        if ((user_input == p.ride_id && p.status == "Pending") || (toLower(user_input) == toLower(p.fname) && p.status == "Pending")) {
+        if (p.status == RideStatus::Pending) {
             ride_found = true;
             full_name = p.fname + " " + p.lname;
             full_name_title = toTitleCase(full_name);
@@ -1024,38 +845,43 @@ void editRides(list<struct person>& people, DriverManager& dm) {
                     case 1: 
                         cout << "\nPlese enter your new contact number: ";
                         cin >> phone_number;
-                        p.phone = phone_number;
+                        service.edit(handle, [&](person& ride) { ride.phone = phone_number; });
                         totalChanges++;
                         break;
 
-                    case 2: 
-                        cout << "\nPlese enter your new Pickup Location: ";
-                        getline(cin >> ws, pick_up);
-                        p.pickup = pick_up;
+                    case 2: {
+                        // Places must be catalog cities, so prompt as booking does
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        const City* pick_up = calculator.promptLocation(cities, "your new pickup", &p.dropoffCity(), "dropoff");
+                        service.edit(handle, [&](person& ride) { ride.pickup = cities.idOf(*pick_up); });
                         totalChanges++;
                         break;
+                    }
                     
-                    case 3: 
-                        cout << "\nPlese enter your new Dropoff Location: ";
-                        getline(cin >> ws, drop_off);
-                        p.dropoff = drop_off;
+                    case 3: {
+                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                        const City* drop_off = calculator.promptLocation(cities, "your new dropoff", &p.pickupCity(), "pickup");
+                        service.edit(handle, [&](person& ride) { ride.dropoff = cities.idOf(*drop_off); });
                         totalChanges++;
                         break;
+                    }
 
                     case 4: 
                         cout << "\nPlese enter your new Date of Ride: ";
                         selectDate(rideMonth, rideYear, rideDay);
-                        p.rideMonth = rideMonth;
-                        p.rideYear = rideYear;
-                        p.rideDay = rideDay;
+                        service.edit(handle, [&](person& ride) { ride.setDate(rideDay, rideMonth, rideYear); });
                         totalChanges++;
                         break;
                     
-                    case 5: 
+                    case 5: {
+                        // Prompt first: the ride is out of the indexes while edit() changes it
                         cout << "\nPlese enter your new Ride Vehicle: ";
-                        vehicle_type(p.vehicle);
+                        VehicleType vehicle = p.vehicle;
+                        vehicle_type(vehicle);
+                        service.edit(handle, [vehicle](person& ride) { ride.vehicle = vehicle; });
                         totalChanges++;
                         break;
+                    }
 
                     
                     case 0:
@@ -1083,8 +909,8 @@ void editRides(list<struct person>& people, DriverManager& dm) {
                 cout << "Ride #" << p.ride_id << ":\n";
                 cout << "Name: " << p.fname << " " << p.lname << endl;
                 cout << "Phone: " << p.phone << endl;
-                cout << "Pickup: " << p.pickup << endl;
-                cout << "Dropoff: " << p.dropoff << endl;
+                cout << "Pickup: " << p.pickupCity().name << endl;
+                cout << "Dropoff: " << p.dropoffCity().name << endl;
                 cout << "Date: " << setw(2) << setfill('0') << p.rideMonth
                     << "/" << setw(2) << p.rideDay << "/" << p.rideYear << endl;
                 cout << "Vehicle: " << p.vehicle << endl;
@@ -1096,8 +922,8 @@ void editRides(list<struct person>& people, DriverManager& dm) {
                 cout << "Ride #" << p.ride_id << ":\n";
                 cout << "Name: " << p.fname << " " << p.lname << endl;
                 cout << "Phone: " << p.phone << endl;
-                cout << "Pickup: " << p.pickup << endl;
-                cout << "Dropoff: " << p.dropoff << endl;
+                cout << "Pickup: " << p.pickupCity().name << endl;
+                cout << "Dropoff: " << p.dropoffCity().name << endl;
                 cout << "Date: " << setw(2) << setfill('0') << p.rideMonth
                     << "/" << setw(2) << p.rideDay << "/" << p.rideYear << endl;
                 cout << "Vehicle: " << p.vehicle << endl;
@@ -1136,13 +962,15 @@ void editRides(list<struct person>& people, DriverManager& dm) {
      }
 
 
-void deleteRides(list<struct person>& people, DriverManager& dm) {
+void deleteRides(RideStore& people, DriverManager& dm) {
 
     string full_name;
     string full_name_title;
     string user_input;
     char choice;
 
+    RideService service(people, dm);
+
     cout << "\n====== DELETING MODE ======";
     do {
     cout << "\nPlease enter the Ride ID Number or first name you want to delete: ";
@@ -1155,51 +983,49 @@ void deleteRides(list<struct person>& people, DriverManager& dm) {
 
 
     bool found = false;
-    auto it = people.begin();
-
-    string lowerInput = toLower(user_input);
+    // Matches come from the id and name indexes; declined ones are not
+    // offered again when the user searches for another record
+    vector<RideHandle> matches = findRides(people, user_input);
+    vector<RideHandle> declined;
+    size_t next = 0;
+
+    while (next < matches.size()) {
+        RideHandle handle = matches[next++];
+        const person* p = people.get(handle);
+        bool wasDeclined = any_of(declined.begin(), declined.end(), [&](RideHandle d) {
+            return d.index == handle.index && d.generation == handle.generation;
+        });
+        if (!p || wasDeclined) continue;
 
+        found = true;
+        full_name = p->fname + " " + p->lname;
+        full_name_title = toTitleCase(full_name);
 
-    while (it != people.end()) {
+        cout << "\nFound ride for: " << full_name_title;
+        cout << "\nRide ID: " << p->ride_id;
+        cout << "\nStatus: " << p->status;
+        cout << "\nDo you want to proceed to delete this record? (y/n): ";
+        cin >> choice;
 
-        if (user_input == it->ride_id ||    
-            toLower(it->fname).find(lowerInput) != string::npos || 
-            toLower(it->lname).find(lowerInput) != string::npos) 
-        {
-            found = true;
-            full_name = it-> fname + " " + it->lname;
-            full_name_title = toTitleCase(full_name);
-            
-            cout << "\nFound ride for: " << full_name_title;
-            cout << "\nRide ID: " << it->ride_id;
-            cout << "\nStatus: " << it->status;
-            cout << "\nDo you want to proceed to delete this record? (y/n): ";
+        if (tolower(choice) == 'y') {
+            service.remove(handle);
+            cout << "\nRecord deleted successfully!";
+            cout << "\nDelete another record? (y/n): ";
             cin >> choice;
-
-            if (tolower(choice) == 'y') {
-                it = people.erase(it);
-                cout << "\nRecord deleted successfully!";
-                cout << "\nDelete another record? (y/n): ";
-                cin >> choice;
-                if (tolower(choice) != 'y') {
-                    clearScreen();
-                    view_all_rides(people, dm);
-                    return;  
-                }
-                
-               
-                cout << "\nEnter new Ride Number ID or partial name: ";
-                cin.ignore();
-                getline(cin, user_input);
-                lowerInput = toLower(user_input);
-                it = people.erase(it); 
-                continue;
-            } else {
-                cout << "\nDeletion cancelled.";
-                ++it;  
+            if (tolower(choice) != 'y') {
+                clearScreen();
+                view_all_rides(people, dm);
+                return;
             }
+
+            cout << "\nEnter new Ride ID number or first name: ";
+            cin.ignore();
+            getline(cin, user_input);
+            matches = findRides(people, user_input);
+            next = 0;
         } else {
-            ++it;  
+            cout << "\nDeletion cancelled.";
+            declined.push_back(handle);
         }
     }
 
@@ -1213,7 +1039,7 @@ void deleteRides(list<struct person>& people, DriverManager& dm) {
 }
 
 
-void goingRides(list<struct person>& people, DriverManager& dm) {
+void goingRides(RideStore& people, DriverManager& dm) {
 
     string full_name;
     string full_name_title;
@@ -1229,8 +1055,9 @@ void goingRides(list<struct person>& people, DriverManager& dm) {
     string lowerInput = toLower(user_input);
     bool ride_found = false;
 
-    for (auto& p: people){
-        if ((user_input == p.ride_id && p.status == "Pending") || (lowerInput == toLower(p.fname) && p.status == "Pending")) {
+    for (RideHandle handle : findRides(people, user_input)) {
+        const person& p = *people.get(handle);
+        if (p.status == RideStatus::Pending) {
             bool ride_found = true;
             full_name = p.fname + " " + p.lname;
             full_name_title = toTitleCase(full_name);
@@ -1243,7 +1070,7 @@ void goingRides(list<struct person>& people, DriverManager& dm) {
 
 
             if (tolower(choice) == 'y') {
-                p.isCurrentRide = true;
+                people.update(handle, [](person& ride) { ride.isCurrentRide = true; });
                 current_ride_details(people, dm);
                 return;
 
@@ -1289,17 +1116,8 @@ bool isNotCanceled(const string& status) {
 }
 
 
-bool isCompleted(const string& status) {
-    string lower = toLower(status);
-    return lower == "completed";
-}
-
-bool isCanceled(const string& status) {
-    string lower = toLower(status);
-    return lower == "canceled";
-}
-
-void cancelRides(list<struct person>& people, DriverManager& dm) {
+void cancelRides(RideStore& people, DriverManager& dm) {
+    RideService service(people, dm);
     cout << "\n====== RIDE CANCELLATION MODE ======";
     cout << "\nEnter the Ride ID Number or first name you want to cancel: ";
     
@@ -1309,11 +1127,8 @@ void cancelRides(list<struct person>& people, DriverManager& dm) {
 
     bool ride_found = false;
 
-    for (auto& p : people) {
-
-        if (user_input != p.ride_id && toLower(user_input) != toLower(p.fname)) {
-            continue;
-        }
+    for (RideHandle handle : findRides(people, user_input)) {
+        const person& p = *people.get(handle);
 
         ride_found = true;
         string full_name = p.fname + " " + p.lname;
@@ -1323,12 +1138,12 @@ void cancelRides(list<struct person>& people, DriverManager& dm) {
         cout << "\nStatus: " << p.status;
 
 
-        if (isCompleted(p.status)) {
+        if (p.status == RideStatus::Completed) {
             cout << "\nError: Completed rides cannot be canceled.\n";
             break;
         }
 
-        else if (isCanceled(p.status)) {
+        else if (p.status == RideStatus::Canceled) {
             cout << "\nRide is already canceled.\n";
             break;
         }
@@ -1339,10 +1154,7 @@ void cancelRides(list<struct person>& people, DriverManager& dm) {
             cin >> choice;
 
             if (tolower(choice) == 'y') {
-                p.status = "Canceled";
-                if (p.assignedDriverId != -1) {
-                    dm.releaseDriver(p.assignedDriverId);  
-                }
+                service.cancel(handle);
                 cout << "\nRide canceled successfully!\n";
             } else {
                 cout << "\nCancellation aborted.\n";
@@ -1427,42 +1239,18 @@ const char* train[] = {
     "<'--0--0--0--0--0--0--0--0--0--0--0--0--0--0'"
 };
 
-void animateVehicle(const string& vehicleType, const string& message = "Your ride is on the way!") {
+void animateVehicle(VehicleType vehicleType, const string& message = "Your ride is on the way!") {
     const char** art = nullptr;
     int lines = 0;
     
-    if (vehicleType == "Bus") {
-        art = bus;
-        lines = 4;
-    } 
-    else if (vehicleType == "Motorcycle") {
-        art = motorcycle;
-        lines = 3;
-    }
-    else if (vehicleType == "Sedan") {
-        art = car;
-        lines = 4;
-    } 
-    else if (vehicleType == "SUV") {
-        art = suv;
-        lines = 4;
-    }
-    else if (vehicleType == "Truck") {
-        art = truck;
-        lines = 4;
-    }
-    else if (vehicleType == "Van") {
-        art = van;
-        lines = 4;
-    }
-    else if (vehicleType == "Train") {
-        art = train;
-        lines = 3;
-    }
-    
-    else {
-        art = car; 
-        lines = 4;
+    switch (vehicleType) {
+        case VehicleType::Bus: art = bus; lines = 4; break;
+        case VehicleType::Motorcycle: art = motorcycle; lines = 3; break;
+        case VehicleType::Sedan: art = car; lines = 4; break;
+        case VehicleType::SUV: art = suv; lines = 4; break;
+        case VehicleType::Truck: art = truck; lines = 4; break;
+        case VehicleType::Van: art = van; lines = 4; break;
+        case VehicleType::Train: art = train; lines = 3; break;
     }
 
     // Animate
@@ -1505,25 +1293,27 @@ bool isRideToday(const person& p) {
 
 
 
-void startRideWithAnimation(list<person>& people, DriverManager& dm) {
+void startRideWithAnimation(RideStore& people, DriverManager& dm) {
     
 
-    vector<string> tempVehicles;
+    vector<VehicleType> tempVehicles;
     
 
     cout << "====== STARTING RIDES SCHEDULED FOR TODAY ======\n\n";
 
     bool foundTodayRide = false;
 
-    for (auto& p : people) {
-        if ((p.status == "Confirmed" || p.status == "Pending") && isRideToday(p)) {
-            foundTodayRide = true;
+    // Today's confirmed and pending rides come straight from the status index
+    auto [currentDay, currentMonth, currentYear] = getCurrentDate();
+    vector<RideHandle> today = people.withStatus(RideStatus::Confirmed, currentDay, currentMonth, currentYear);
+    vector<RideHandle> pending = people.withStatus(RideStatus::Pending, currentDay, currentMonth, currentYear);
+    today.insert(today.end(), pending.begin(), pending.end());
 
-            tempVehicles.push_back(p.vehicle);
-             p.status = "Completed";
-        
-           
-        }
+    for (RideHandle handle : today) {
+        foundTodayRide = true;
+
+        tempVehicles.push_back(people.get(handle)->vehicle);
+        people.update(handle, [](person& ride) { ride.status = RideStatus::Completed; });
     }
 
 
@@ -1542,8 +1332,8 @@ void startRideWithAnimation(list<person>& people, DriverManager& dm) {
             cout << "\n\nThere was a problem with your booking\n";
             cout << "Booking is canceled\n";
             cout << string(40, '=') << "\n\n";
-            for (auto& p : people) {
-                p.status = "Canceled";
+            for (RideHandle handle : today) {
+                people.update(handle, [](person& ride) { ride.status = RideStatus::Canceled; });
             }
 
         }
@@ -1558,4 +1348,36 @@ void startRideWithAnimation(list<person>& people, DriverManager& dm) {
     cout << "Press Enter to continue...";
     cin.ignore();
     cin.get();
-}
\ No newline at end of file
+}
+
+
+// Re-match every pending ride for today in one batch, so drivers go where
+// they add the least pickup distance overall
+void dispatchPendingRides(RideStore& people, DriverManager& dm) {
+    RideService service(people, dm);
+    auto [currentDay, currentMonth, currentYear] = getCurrentDate();
+    RideService::Dispatch dispatch = service.dispatchPending(currentDay, currentMonth, currentYear);
+    const vector<RideHandle>& batch = dispatch.rides;
+    const BatchDispatcher::Result& result = dispatch.result;
+
+    if (batch.empty()) {
+        cout << "No pending rides for today.\n";
+        return;
+    }
+
+    cout << "\n=== Batch Dispatch ===\n";
+    cout << fixed << setprecision(2);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const person& p = *people.get(batch[i]);
+        cout << p.ride_id << " " << p.fname << " " << p.lname << " (" << p.vehicle << ", " << p.pickupCity().name << "): ";
+        if (result.driverIds[i] == -1) {
+            cout << "no driver available\n";
+        } else {
+            cout << "driver " << result.driverIds[i] << ", " << result.pickupKm[i] << " km away\n";
+        }
+    }
+    cout << "----------------------\n";
+    cout << "Matched " << result.matched << " of " << batch.size() << " rides in "
+         << result.milliseconds << " ms (" << (result.exact ? "optimal" : "greedy for large groups") << ")\n";
+    cout << "Total pickup distance: " << result.totalKm << " km (greedy: " << result.greedyKm << " km)\n";
+}
@@ -0,0 +1,124 @@
+#include "name_index.h"
+
+using namespace std;
+
+// ASCII versions of isalnum() and tolower(), matching normalizeName() in
+// the "C" locale without a library call per character
+static inline bool isKeyChar(char c) {
+    char lower = static_cast<char>(c | 0x20);
+    return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z');
+}
+
+static inline char keyChar(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+// First slot to probe. FNV-1a leaves similar names ("Stop 1", "Stop 2")
+// close together in the low bits, so mix them before masking.
+static inline size_t homeSlot(uint32_t hash, size_t mask) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash & mask;
+}
+
+uint32_t NameIndex::hashKey(string_view name) {
+    // 32-bit FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        if (!isKeyChar(c)) continue;
+        hash ^= static_cast<unsigned char>(keyChar(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool NameIndex::sameKey(string_view a, string_view b) {
+    size_t i = 0, j = 0;
+    while (true) {
+        while (i < a.size() && !isKeyChar(a[i])) i++;
+        while (j < b.size() && !isKeyChar(b[j])) j++;
+        if (i == a.size() || j == b.size()) {
+            return i == a.size() && j == b.size();
+        }
+        if (keyChar(a[i]) != keyChar(b[j])) return false;
+        i++;
+        j++;
+    }
+}
+
+void NameIndex::reserve(size_t wanted) {
+    own();
+
+    // Keep the load factor at or below one half
+    size_t capacity = 16;
+    while (capacity < wanted * 2) capacity *= 2;
+    if (capacity <= slots.size()) return;
+
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(capacity, {0, NOT_FOUND});
+
+    size_t mask = slots.size() - 1;
+    for (const auto& slot : old) {
+        if (slot.id == NOT_FOUND) continue;
+        size_t pos = homeSlot(slot.hash, mask);
+        while (slots[pos].id != NOT_FOUND) pos = (pos + 1) & mask;
+        slots[pos] = slot;
+    }
+}
+
+void NameIndex::borrow(const Slot* saved, size_t slotCount, size_t entries) {
+    slots.clear();
+    borrowed = saved;
+    borrowedSize = slotCount;
+    count = entries;
+}
+
+void NameIndex::own() {
+    if (!borrowed) return;
+    slots.assign(borrowed, borrowed + borrowedSize);
+    borrowed = nullptr;
+    borrowedSize = 0;
+}
+
+void NameIndex::grow() {
+    reserve(count + 1);
+}
+
+uint32_t NameIndex::find(string_view name, const vector<City>& cities) const {
+    const Slot* table = tableData();
+    size_t size = tableSize();
+    if (size == 0) return NOT_FOUND;
+
+    uint32_t hash = hashKey(name);
+    size_t mask = size - 1;
+    for (size_t pos = homeSlot(hash, mask); table[pos].id != NOT_FOUND; pos = (pos + 1) & mask) {
+        const Slot& slot = table[pos];
+        if (slot.hash == hash && sameKey(cities[slot.id].name, name)) {
+            return slot.id;
+        }
+    }
+    return NOT_FOUND;
+}
+
+uint32_t NameIndex::insert(uint32_t id, const vector<City>& cities) {
+    grow();
+
+    string_view name = cities[id].name;
+    uint32_t hash = hashKey(name);
+    size_t mask = slots.size() - 1;
+    size_t pos = homeSlot(hash, mask);
+    for (; slots[pos].id != NOT_FOUND; pos = (pos + 1) & mask) {
+        const Slot& slot = slots[pos];
+        if (slot.hash == hash && sameKey(cities[slot.id].name, name)) {
+            return slot.id;
+        }
+    }
+
+    slots[pos] = {hash, id};
+    count++;
+    return id;
+}
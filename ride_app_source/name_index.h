@@ -0,0 +1,57 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include "distance_calculator.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Open-addressing hash table from normalized city name to city id.
+// Keys are never stored: hashing and comparing walk the original names
+// and skip non-alphanumeric characters, so lookups allocate nothing.
+class NameIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;
+    };
+
+    // Hash of normalizeName(name), computed without building the string
+    static uint32_t hashKey(std::string_view name);
+    // normalizeName(a) == normalizeName(b), without building either string
+    static bool sameKey(std::string_view a, std::string_view b);
+
+    void reserve(size_t count);
+
+    // Id of the city whose name normalizes like `name`, or NOT_FOUND
+    uint32_t find(std::string_view name, const std::vector<City>& cities) const;
+
+    // Index cities[id]. If a city with the same key is already indexed its
+    // id is returned and nothing is inserted, otherwise returns `id`.
+    uint32_t insert(uint32_t id, const std::vector<City>& cities);
+
+    size_t size() const { return count; }
+
+    // Raw slots, for saving the index with a catalog snapshot
+    const Slot* tableData() const { return borrowed ? borrowed : slots.data(); }
+    size_t tableSize() const { return borrowed ? borrowedSize : slots.size(); }
+
+    // Use slots saved from tableData() in place, e.g. from a memory-mapped
+    // snapshot holding `entries` names. They must outlive the index; they
+    // are copied only if something is inserted later.
+    void borrow(const Slot* saved, size_t slotCount, size_t entries);
+
+private:
+    void grow();
+    // Copy borrowed slots into slots so they can be modified
+    void own();
+
+    std::vector<Slot> slots;
+    const Slot* borrowed = nullptr;
+    size_t borrowedSize = 0;
+    size_t count = 0;
+};
+
+#endif // NAME_INDEX_H
@@ -0,0 +1,67 @@
+#include "prefix_index.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+PrefixIndex::PrefixIndex(const vector<City>& cities) : cities(cities) {
+    keys.reserve(cities.size());
+    names.reserve(cities.size());
+
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        // Normalize by hand to remember where each word starts in the key
+        string key;
+        bool wordStart = true;
+        for (char c : cities[id].name) {
+            if (isalnum(static_cast<unsigned char>(c))) {
+                if (wordStart) {
+                    Entry entry = {id, static_cast<uint32_t>(key.size())};
+                    (key.empty() ? names : words).push_back(entry);
+                }
+                key += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+                wordStart = false;
+            } else {
+                wordStart = true;
+            }
+        }
+        keys.push_back(key);
+    }
+
+    auto bySuffix = [this](const Entry& a, const Entry& b) {
+        return suffix(a) < suffix(b);
+    };
+    sort(names.begin(), names.end(), bySuffix);
+    sort(words.begin(), words.end(), bySuffix);
+}
+
+string_view PrefixIndex::suffix(const Entry& entry) const {
+    return string_view(keys[entry.id]).substr(entry.offset);
+}
+
+void PrefixIndex::collect(const vector<Entry>& sorted, const string& key,
+                          size_t k, vector<const City*>& results) const {
+    auto it = lower_bound(sorted.begin(), sorted.end(), key, [this](const Entry& e, const string& p) {
+        return suffix(e) < p;
+    });
+
+    for (; it != sorted.end() && results.size() < k; ++it) {
+        if (suffix(*it).compare(0, key.size(), key) != 0) break;
+
+        const City* city = &cities[it->id];
+        if (find(results.begin(), results.end(), city) == results.end()) {
+            results.push_back(city);
+        }
+    }
+}
+
+vector<const City*> PrefixIndex::complete(const string& prefix, size_t k) const {
+    vector<const City*> results;
+    string key = normalizeName(prefix);
+    if (key.empty() || k == 0) return results;
+
+    // Whole-name matches first, then word matches, each in name order.
+    // Scans stop after k hits, so the cost does not grow with the catalog.
+    collect(names, key, k, results);
+    collect(words, key, k, results);
+    return results;
+}
@@ -0,0 +1,39 @@
+#ifndef PREFIX_INDEX_H
+#define PREFIX_INDEX_H
+
+#include "distance_calculator.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Autocomplete over city names. Normalized names and the later word
+// starts inside them are kept in sorted arrays, so "cub" finds both
+// "Cubao" and "Araneta Center-Cubao Station" with a binary search and a
+// short scan.
+class PrefixIndex {
+public:
+    explicit PrefixIndex(const std::vector<City>& cities);
+
+    // Up to k cities whose name or one of its words starts with prefix.
+    // Names that start with the prefix come first, then word matches.
+    std::vector<const City*> complete(const std::string& prefix, size_t k) const;
+
+private:
+    struct Entry {
+        uint32_t id;       // city id
+        uint32_t offset;   // word start within keys[id]
+    };
+
+    std::string_view suffix(const Entry& entry) const;
+    // Add matches from one sorted array until results holds k cities
+    void collect(const std::vector<Entry>& sorted, const std::string& key,
+                 size_t k, std::vector<const City*>& results) const;
+
+    const std::vector<City>& cities;
+    std::vector<std::string> keys;   // normalizeName() of each city
+    std::vector<Entry> names;        // whole names, sorted by suffix()
+    std::vector<Entry> words;        // later word starts, sorted by suffix()
+};
+
+#endif // PREFIX_INDEX_H
@@ -0,0 +1,52 @@
+#include "rail_lines.h"
+#include <cmath>
+
+using namespace std;
+
+const RailLines& RailLines::instance() {
+    static const RailLines lines(CityCatalog::instance());
+    return lines;
+}
+
+RailLines::RailLines(const CityCatalog& catalog) : catalog(catalog) {
+    const auto& cities = catalog.cities();
+    DistanceCalculator calculator;
+    along.assign(cities.size(), 0.0);
+    line.assign(cities.size(), NO_LINE);
+
+    // Catalog ids follow file order, so a line's stations are consecutive
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        CitySource source = cities[id].source;
+        if (!(RAIL_STATIONS & sourceBit(source))) continue;
+
+        line[id] = static_cast<uint8_t>(source);
+        if (id > 0 && line[id - 1] == line[id]) {
+            along[id] = along[id - 1] + calculator.calculateDistance(cities[id - 1], cities[id]);
+        }
+    }
+}
+
+double RailLines::trackDistance(const City& a, const City& b) const {
+    return trackDistance(catalog.idOf(a), catalog.idOf(b));
+}
+
+double RailLines::trackDistance(uint32_t a, uint32_t b) const {
+    if (line[a] == NO_LINE || line[a] != line[b]) return -1;
+    return fabs(along[a] - along[b]);
+}
+
+void RailLines::priceTrips(const uint32_t* from, const uint32_t* to, size_t count,
+                           const VehicleRate& rate, double* out) const {
+    const double* km = along.data();
+    const uint8_t* lineOf = line.data();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t a = from[i], b = to[i];
+        bool sameLine = lineOf[a] != NO_LINE && lineOf[a] == lineOf[b];
+        double fare = rate.baseFare + rate.perKmRate * fabs(km[a] - km[b]);
+        out[i] = sameLine ? fare : -1;
+    }
+}
+
+bool RailLines::isStation(const City& place) const {
+    return line[catalog.idOf(place)] != NO_LINE;
+}
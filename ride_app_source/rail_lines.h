@@ -0,0 +1,40 @@
+#ifndef RAIL_LINES_H
+#define RAIL_LINES_H
+
+#include "city_catalog.h"
+#include <cstdint>
+#include <vector>
+
+// Along-the-track distances for the rail lines. LRT.csv, LRT-2.csv,
+// MRT-3.csv and PNR.csv list stations in line order, so each station gets
+// the cumulative km from the start of its line, and the track distance
+// between two stations of the same line is the difference of the two.
+class RailLines {
+public:
+    // The shared table for CityCatalog::instance() (built on first use)
+    static const RailLines& instance();
+
+    explicit RailLines(const CityCatalog& catalog);
+
+    // Track km between two stations of the same line, -1 otherwise
+    double trackDistance(const City& a, const City& b) const;
+    double trackDistance(uint32_t a, uint32_t b) const;
+
+    // Fares for count trips given as catalog ids: out[i] prices from[i]
+    // to to[i] at rate, or is -1 if the pair is not on a single line
+    void priceTrips(const uint32_t* from, const uint32_t* to, size_t count,
+                    const VehicleRate& rate, double* out) const;
+
+    // True if the place is a station on one of the lines
+    bool isStation(const City& place) const;
+
+private:
+    static constexpr uint8_t NO_LINE = 0xFF;
+
+    const CityCatalog& catalog;
+    // Per catalog id: km from the first station of its line, and the line
+    std::vector<double> along;
+    std::vector<uint8_t> line;
+};
+
+#endif // RAIL_LINES_H
@@ -0,0 +1,144 @@
+#include "ride_grouping.h"
+
+using namespace std;
+
+// Spread the bits of a 64-bit value (the splitmix64 finalizer), so keys
+// that differ only in a small field land far apart
+static inline uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+// Open-addressing table sized to a power of two at least twice `count`
+template <typename Slot>
+static void sizeTable(vector<Slot>& slots, size_t count, Slot empty) {
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    slots.assign(capacity, empty);
+}
+
+uint32_t RideGroups::hashKey(const RideGroupKey& key) {
+    uint64_t route = (static_cast<uint64_t>(key.pickup) << 32) | key.dropoff;
+    uint64_t when = (static_cast<uint64_t>(static_cast<uint32_t>(key.date)) << 8) | static_cast<uint64_t>(key.vehicle);
+    return static_cast<uint32_t>(mix(route ^ mix(when)));
+}
+
+void RideGroups::grow() {
+    vector<Slot> old;
+    old.swap(slots);
+    sizeTable(slots, old.size(), Slot{0, EMPTY});
+
+    size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.group == EMPTY) continue;
+        size_t pos = slot.hash & mask;
+        while (slots[pos].group != EMPTY) pos = (pos + 1) & mask;
+        slots[pos] = slot;
+    }
+}
+
+uint32_t RideGroups::groupFor(const RideGroupKey& key) {
+    // Keep the load factor at or below one half
+    if ((list.size() + 1) * 2 > slots.size()) grow();
+
+    uint32_t hash = hashKey(key);
+    size_t mask = slots.size() - 1;
+    size_t pos = hash & mask;
+    while (slots[pos].group != EMPTY) {
+        if (slots[pos].hash == hash && list[slots[pos].group].key == key) return slots[pos].group;
+        pos = (pos + 1) & mask;
+    }
+
+    uint32_t group = static_cast<uint32_t>(list.size());
+    slots[pos] = {hash, group};
+    list.push_back({key, 0, 0});
+    return group;
+}
+
+RideGroups::RideGroups(const RideStore& rides, initializer_list<RideStatus> statuses) {
+    bool wanted[RIDE_STATUS_COUNT] = {};
+    for (RideStatus status : statuses) wanted[static_cast<size_t>(status)] = true;
+    sizeTable(slots, 32, Slot{0, EMPTY});
+
+    // Find every ride's group, then lay the rides out group by group
+    vector<const person*> found;
+    vector<uint32_t> groupOf;
+    found.reserve(rides.size());
+    groupOf.reserve(rides.size());
+    for (const person& ride : rides) {
+        if (!wanted[static_cast<size_t>(ride.status)]) continue;
+        uint32_t group = groupFor({ride.vehicle, ride.dateKey(), ride.pickup, ride.dropoff});
+        list[group].count++;
+        found.push_back(&ride);
+        groupOf.push_back(group);
+    }
+
+    uint32_t next = 0;
+    for (Group& group : list) {
+        group.first = next;
+        next += group.count;
+        group.count = 0;
+    }
+    riders.resize(found.size());
+    for (size_t i = 0; i < found.size(); ++i) {
+        Group& group = list[groupOf[i]];
+        riders[group.first + group.count++] = found[i];
+    }
+}
+
+int countDuplicateVectors(const list<vector<string>>& data, ostream& out) {
+    if (data.size() < 2) return 0;
+
+    // Entries are hashed whole into an open-addressing table of first
+    // occurrences, so each one is compared only with entries of the same hash
+    struct Slot {
+        uint64_t hash;
+        uint32_t first;
+    };
+    constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    vector<const vector<string>*> entries;
+    entries.reserve(data.size());
+    for (const auto& entry : data) entries.push_back(&entry);
+
+    vector<Slot> slots;
+    sizeTable(slots, entries.size(), Slot{0, EMPTY});
+    size_t mask = slots.size() - 1;
+    vector<uint32_t> copies(entries.size(), 0);
+
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        // FNV-1a over each value and its length, so ("ab", "c") and
+        // ("a", "bc") differ
+        uint64_t hash = 14695981039346656037ull;
+        for (const string& value : *entries[i]) {
+            for (char c : value) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+            hash = mix(hash ^ value.size());
+        }
+
+        size_t pos = hash & mask;
+        while (slots[pos].first != EMPTY &&
+               !(slots[pos].hash == hash && *entries[slots[pos].first] == *entries[i])) {
+            pos = (pos + 1) & mask;
+        }
+        if (slots[pos].first == EMPTY) slots[pos] = {hash, i};
+        copies[slots[pos].first]++;
+    }
+
+    int duplicateTotal = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (copies[i] < 2) continue;
+        duplicateTotal += static_cast<int>(copies[i] - 1);    // Count extras beyond first
+        out << "Found " << copies[i] << " copies of: ";
+        for (const auto& val : *entries[i]) out << val << " ";
+        out << endl;
+    }
+
+    return duplicateTotal;
+}
@@ -0,0 +1,70 @@
+#ifndef RIDE_GROUPING_H
+#define RIDE_GROUPING_H
+
+#include "ride_store.h"
+#include <cstdint>
+#include <initializer_list>
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What rides must have in common to share a trip
+struct RideGroupKey {
+    VehicleType vehicle;
+    int date;           // person::dateKey()
+    uint32_t pickup;
+    uint32_t dropoff;
+
+    bool operator==(const RideGroupKey& other) const {
+        return vehicle == other.vehicle && date == other.date && pickup == other.pickup && dropoff == other.dropoff;
+    }
+};
+
+// Rides grouped by vehicle, date, pickup and dropoff in one pass over the
+// store. Keys are a few integers, hashed into an open-addressing table,
+// so each ride costs one probe, not a chain of comparisons down a tree.
+// Groups are in the order their first ride was booked, and so are the
+// rides within a group.
+class RideGroups {
+public:
+    struct Group {
+        RideGroupKey key;
+        uint32_t first = 0;     // index of its first ride in riders
+        uint32_t count = 0;
+    };
+
+    // Group the rides whose status is one of `statuses`
+    RideGroups(const RideStore& rides, std::initializer_list<RideStatus> statuses);
+
+    const std::vector<Group>& groups() const { return list; }
+    size_t size() const { return list.size(); }
+    // The rides of a group, group.count of them
+    const person* const* ridersOf(const Group& group) const { return riders.data() + group.first; }
+
+    // Rides grouped, and how many of them join a group someone else started
+    size_t rideCount() const { return riders.size(); }
+    size_t duplicates() const { return riders.size() - list.size(); }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t group;
+    };
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    static uint32_t hashKey(const RideGroupKey& key);
+    // The group with this key, started if there is none
+    uint32_t groupFor(const RideGroupKey& key);
+    void grow();
+
+    std::vector<Slot> slots;
+    std::vector<Group> list;
+    std::vector<const person*> riders;
+};
+
+// Number of entries in data that repeat an earlier one. Each set of
+// copies is reported to out, in the order the first of them appears.
+int countDuplicateVectors(const std::list<std::vector<std::string>>& data, std::ostream& out);
+
+#endif // RIDE_GROUPING_H
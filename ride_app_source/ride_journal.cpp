@@ -0,0 +1,735 @@
+#include "ride_journal.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char JOURNAL_MAGIC[4] = {'G', 'R', 'J', 'L'};
+static constexpr uint32_t JOURNAL_VERSION = 1;
+static constexpr size_t FILE_HEADER_BYTES = 8;      // magic, version
+static constexpr size_t RECORD_HEADER_BYTES = 8;    // payload size, checksum
+
+enum RecordType : uint8_t { PUT = 1, ERASE = 2 };
+
+// Record layout, host byte order like the catalog snapshot:
+//   payload size u32 | checksum u32 | type u8 | handle index u32 | generation u32
+//   and for PUT: fare f64 | driver i32 | date u32 (yyyymmdd) | persons u16
+//   | status u8 | vehicle u8 | current u8 | then ride id, first name, last
+//   name, phone, pickup and dropoff, each as length u16 + bytes.
+// Every segment file starts with the magic and version.
+// Places are stored by name, so catalog ids may change between runs.
+
+// 32-bit FNV-1a
+static uint32_t checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+static void put(string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static constexpr size_t MAX_TEXT_BYTES = 0xFFFF;
+
+// A longer field would wrap its u16 length and garble every record after
+// it, so it is cut short instead
+static void putText(string& out, string_view text) {
+    if (text.size() > MAX_TEXT_BYTES) {
+        cerr << "Warning: Journal field of " << text.size() << " bytes cut to " << MAX_TEXT_BYTES << endl;
+        text = text.substr(0, MAX_TEXT_BYTES);
+    }
+    put(out, static_cast<uint16_t>(text.size()));
+    out.append(text.data(), text.size());
+}
+
+// Reads fields back; every read fails once the payload runs out
+struct RecordReader {
+    const char* at;
+    const char* end;
+
+    template <typename T>
+    bool get(T& value) {
+        if (static_cast<size_t>(end - at) < sizeof(T)) return false;
+        memcpy(&value, at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+
+    bool getText(string_view& text) {
+        uint16_t size;
+        if (!get(size) || static_cast<size_t>(end - at) < size) return false;
+        text = string_view(at, size);
+        at += size;
+        return true;
+    }
+};
+
+// A record starts with room for its header; seal() fills it in
+static string startRecord(RecordType type, RideHandle handle) {
+    string record(RECORD_HEADER_BYTES, '\0');
+    put(record, static_cast<uint8_t>(type));
+    put(record, handle.index);
+    put(record, handle.generation);
+    return record;
+}
+
+static void seal(string& record) {
+    uint32_t size = static_cast<uint32_t>(record.size() - RECORD_HEADER_BYTES);
+    uint32_t sum = checksum(record.data() + RECORD_HEADER_BYTES, size);
+    memcpy(&record[0], &size, sizeof(size));
+    memcpy(&record[4], &sum, sizeof(sum));
+}
+
+// Catalog id of a journaled place, NO_CITY if the catalog no longer has it
+static uint32_t placeId(const CityCatalog& cities, string_view name) {
+    if (name.empty()) return person::NO_CITY;
+    string key(name);
+    const City* city = cities.find(key);
+    if (!city) city = cities.findNormalized(key);
+    if (!city) {
+        cerr << "Warning: Journal place not in the catalog - " << name << endl;
+        return person::NO_CITY;
+    }
+    return cities.idOf(*city);
+}
+
+
+// Fixed part of a ride, shared by PUT records and the snapshot: fare,
+// driver, date, persons, status, vehicle, current, then the four strings
+static void putRide(string& out, const person& ride) {
+    put(out, ride.totalFare);
+    put(out, ride.assignedDriverId);
+    put(out, static_cast<uint32_t>(ride.dateKey()));
+    put(out, ride.num_of_persons);
+    put(out, static_cast<uint8_t>(ride.status));
+    put(out, static_cast<uint8_t>(ride.vehicle));
+    put(out, static_cast<uint8_t>(ride.isCurrentRide));
+    putText(out, ride.ride_id);
+    putText(out, ride.fname);
+    putText(out, ride.lname);
+    putText(out, ride.phone);
+}
+
+static bool getRide(RecordReader& in, person& ride) {
+    uint32_t date;
+    uint8_t status, vehicle, current;
+    string_view rideId, fname, lname, phone;
+    if (!in.get(ride.totalFare) || !in.get(ride.assignedDriverId) || !in.get(date) ||
+        !in.get(ride.num_of_persons) || !in.get(status) || !in.get(vehicle) || !in.get(current) ||
+        !in.getText(rideId) || !in.getText(fname) || !in.getText(lname) || !in.getText(phone) ||
+        status >= RIDE_STATUS_COUNT || vehicle >= VEHICLE_TYPE_COUNT) {
+        return false;
+    }
+    ride.setDate(date % 100, date / 100 % 100, date / 10000);
+    ride.status = static_cast<RideStatus>(status);
+    ride.vehicle = static_cast<VehicleType>(vehicle);
+    ride.isCurrentRide = current != 0;
+    ride.ride_id = rideId;
+    ride.fname = fname;
+    ride.lname = lname;
+    ride.phone = phone;
+    return true;
+}
+
+static string_view placeName(uint32_t id) {
+    return (id < CityCatalog::instance().size()) ? person::cityAt(id).name : string_view();
+}
+
+#ifdef _WIN32
+
+static intptr_t openForWrite(const string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return (file == INVALID_HANDLE_VALUE) ? -1 : reinterpret_cast<intptr_t>(file);
+}
+
+static bool writeAll(intptr_t file, const char* data, size_t size) {
+    while (size > 0) {
+        DWORD chunk = static_cast<DWORD>(min<size_t>(size, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(reinterpret_cast<HANDLE>(file), data, chunk, &written, nullptr)) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool syncFile(intptr_t file) {
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(file)) != 0;
+}
+
+static void closeFile(intptr_t file) {
+    CloseHandle(reinterpret_cast<HANDLE>(file));
+}
+
+// NTFS commits creates and renames with the file itself
+static bool syncDirectory(const string&) {
+    return true;
+}
+
+#else
+
+static intptr_t openForWrite(const string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static bool writeAll(intptr_t file, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(static_cast<int>(file), data, size);
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool syncFile(intptr_t file) {
+#ifdef __APPLE__
+    return ::fsync(static_cast<int>(file)) == 0;
+#else
+    return ::fdatasync(static_cast<int>(file)) == 0;
+#endif
+}
+
+static void closeFile(intptr_t file) {
+    ::close(static_cast<int>(file));
+}
+
+// A new or renamed file only survives a crash once its directory is synced
+static bool syncDirectory(const string& path) {
+    int dir = ::open(path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir < 0) return false;
+    bool ok = ::fsync(dir) == 0;
+    ::close(dir);
+    return ok;
+}
+
+#endif
+
+static string directoryOf(const string& path) {
+    fs::path parent = fs::path(path).parent_path();
+    return parent.empty() ? string(".") : parent.string();
+}
+
+RideJournal::~RideJournal() {
+    close();
+}
+
+string RideJournal::segmentPath(uint64_t number) const {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%06llu.journal", static_cast<unsigned long long>(number));
+    return base + suffix;
+}
+
+string RideJournal::snapshotPath() const {
+    return base + ".snapshot";
+}
+
+vector<uint64_t> RideJournal::listSegments() const {
+    vector<uint64_t> numbers;
+    const string prefix = fs::path(base).filename().string() + "-";
+    const string suffix = ".journal";
+    error_code ec;
+    for (const auto& entry : fs::directory_iterator(directoryOf(base), ec)) {
+        string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        if (digits.find_first_not_of("0123456789") != string::npos) continue;
+        numbers.push_back(stoull(digits));
+    }
+    sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+bool RideJournal::open(const string& journalBase, RideStore& store) {
+    close();
+    base = journalBase;
+    restored = replayed = 0;
+    pending.clear();
+    appended = durable = syncs = checkpoints = 0;
+    stopping = sealRequested = failed = false;
+
+    uint64_t covered = 0;
+    if (!loadSnapshot(snapshotPath(), store, covered)) {
+        cerr << "Error: " << snapshotPath() << " is not a ride snapshot" << endl;
+        store.clear();
+        return false;
+    }
+    restored = store.size();
+
+    // Segments up to covered are already in the snapshot; a crash between
+    // writing it and deleting them leaves them behind for the next checkpoint
+    uint64_t last = covered;
+    for (uint64_t number : listSegments()) {
+        if (number <= covered) continue;
+        string file = segmentPath(number);
+        uint64_t validBytes = 0;
+        size_t records = 0;
+        if (!replaySegment(file, store, validBytes, records)) {
+            cerr << "Error: " << file << " is not a ride journal" << endl;
+            store.clear();
+            return false;
+        }
+        replayed += records;
+        error_code ec;
+        if (records == 0) {
+            // Left by a run that changed nothing; its number is reused
+            fs::remove(file, ec);
+            continue;
+        }
+        if (fs::file_size(file, ec) != validBytes) {
+            cerr << "Warning: Dropping a torn record at the end of " << file << endl;
+            fs::resize_file(file, validBytes, ec);
+        }
+        last = number;
+    }
+
+    if (!startSegment(last + 1)) {
+        store.clear();
+        return false;
+    }
+    // Anything replayed is sealed; the checkpoint thread folds it in
+    sealedUpTo = last;
+    snapshotUpTo = foldTried = covered;
+    writer = thread(&RideJournal::writerLoop, this);
+    checkpointer = thread(&RideJournal::checkpointLoop, this);
+    return true;
+}
+
+void RideJournal::close() {
+    if (writer.joinable()) {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        sealed.notify_all();
+        writer.join();
+        checkpointer.join();
+    }
+    if (fileHandle != -1) {
+        closeFile(fileHandle);
+        fileHandle = -1;
+    }
+}
+
+bool RideJournal::startSegment(uint64_t number) {
+    string file = segmentPath(number);
+    intptr_t next = openForWrite(file);
+    if (next == -1) {
+        cerr << "Error: Could not open ride journal " << file << endl;
+        return false;
+    }
+    string header(JOURNAL_MAGIC, 4);
+    put(header, JOURNAL_VERSION);
+    if (!writeAll(next, header.data(), header.size()) || !syncFile(next) || !syncDirectory(directoryOf(file))) {
+        cerr << "Error: Could not write ride journal " << file << endl;
+        closeFile(next);
+        return false;
+    }
+
+    if (fileHandle != -1) closeFile(fileHandle);
+    fileHandle = next;
+    segment = number;
+    segmentBytes = header.size();
+    return true;
+}
+
+bool RideJournal::replaySegment(const string& file, RideStore& store, uint64_t& validBytes, size_t& records) {
+    validBytes = 0;
+    records = 0;
+    // Missing, or cut short before the header was synced: nothing in it
+    MappedFile mapped;
+    if (!mapped.open(file) || mapped.size() < FILE_HEADER_BYTES) return true;
+
+    const char* data = mapped.data();
+    uint32_t version;
+    memcpy(&version, data + 4, sizeof(version));
+    if (memcmp(data, JOURNAL_MAGIC, 4) != 0 || version != JOURNAL_VERSION) return false;
+
+    const CityCatalog& cities = CityCatalog::instance();
+    bool mismatch = false;
+    size_t offset = FILE_HEADER_BYTES;
+    while (mapped.size() - offset >= RECORD_HEADER_BYTES) {
+        uint32_t size, sum;
+        memcpy(&size, data + offset, sizeof(size));
+        memcpy(&sum, data + offset + 4, sizeof(sum));
+        const char* payload = data + offset + RECORD_HEADER_BYTES;
+        if (mapped.size() - offset - RECORD_HEADER_BYTES < size || checksum(payload, size) != sum) break;
+
+        RecordReader in{payload, payload + size};
+        uint8_t type;
+        RideHandle handle;
+        if (!in.get(type) || !in.get(handle.index) || !in.get(handle.generation)) break;
+
+        if (type == PUT) {
+            person ride;
+            string_view pickup, dropoff;
+            if (!getRide(in, ride) || !in.getText(pickup) || !in.getText(dropoff)) break;
+            ride.pickup = placeId(cities, pickup);
+            ride.dropoff = placeId(cities, dropoff);
+
+            // An existing handle is an edit; a new one was a booking, and
+            // adding in the same order hands out the same handle again
+            if (store.get(handle)) {
+                store.update(handle, [&ride](person& stored) { stored = move(ride); });
+            } else {
+                RideHandle added = store.add(move(ride));
+                mismatch |= added.index != handle.index || added.generation != handle.generation;
+            }
+        } else if (type == ERASE) {
+            mismatch |= !store.erase(handle);
+        } else {
+            break;
+        }
+
+        offset += RECORD_HEADER_BYTES + size;
+        records++;
+    }
+
+    if (mismatch) {
+        cerr << "Warning: " << file << " does not match the rides already loaded" << endl;
+    }
+    validBytes = offset;
+    return true;
+}
+
+uint64_t RideJournal::recordPut(RideHandle handle, const person& ride) {
+    string payload = startRecord(PUT, handle);
+    putRide(payload, ride);
+    putText(payload, placeName(ride.pickup));
+    putText(payload, placeName(ride.dropoff));
+    seal(payload);
+    return append(payload);
+}
+
+uint64_t RideJournal::recordErase(RideHandle handle) {
+    string payload = startRecord(ERASE, handle);
+    seal(payload);
+    return append(payload);
+}
+
+uint64_t RideJournal::append(const string& record) {
+    uint64_t sequence;
+    bool idle;
+    {
+        lock_guard<mutex> guard(lock);
+        // The writer only sleeps with nothing pending
+        idle = pending.empty();
+        pending += record;
+        sequence = ++appended;
+    }
+    if (idle) wake.notify_one();
+    return sequence;
+}
+
+bool RideJournal::waitDurable(uint64_t sequence) {
+    unique_lock<mutex> guard(lock);
+    if (isOpen()) synced.wait(guard, [&] { return durable >= sequence || failed; });
+    return durable >= sequence;
+}
+
+bool RideJournal::waitDurable() {
+    uint64_t last;
+    {
+        lock_guard<mutex> guard(lock);
+        last = appended;
+    }
+    return waitDurable(last);
+}
+
+bool RideJournal::checkpoint() {
+    if (!isOpen()) return false;
+    unique_lock<mutex> guard(lock);
+    uint64_t before = sealedUpTo;
+    sealRequested = true;
+    wake.notify_one();
+    // The writer clears the request whether or not the new segment started
+    sealed.wait(guard, [&] { return stopping || !sealRequested; });
+    if (sealedUpTo == before) return false;     // could not start a new segment
+
+    uint64_t target = sealedUpTo;
+    folded.wait(guard, [&] { return stopping || foldTried >= target; });
+    return snapshotUpTo >= target;
+}
+
+uint64_t RideJournal::appendedCount() const {
+    lock_guard<mutex> guard(lock);
+    return appended;
+}
+
+uint64_t RideJournal::syncCount() const {
+    lock_guard<mutex> guard(lock);
+    return syncs;
+}
+
+uint64_t RideJournal::checkpointCount() const {
+    lock_guard<mutex> guard(lock);
+    return checkpoints;
+}
+
+void RideJournal::writerLoop() {
+    string batch;
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        auto ready = [this] { return stopping || sealRequested || !pending.empty(); };
+        // An empty segment has no age to run out, nor does one that failed
+        if (segmentBytes > FILE_HEADER_BYTES && !failed) {
+            wake.wait_until(guard, segmentStarted + SEGMENT_AGE, ready);
+        } else {
+            wake.wait(guard, ready);
+        }
+
+        if (failed) {
+            // Records after a lost batch would replay onto the wrong rides
+            pending.clear();
+        } else if (!pending.empty()) {
+            // Everything appended while the last sync ran goes out together
+            batch.swap(pending);
+            uint64_t upTo = appended;
+            guard.unlock();
+
+            bool ok = writeAll(fileHandle, batch.data(), batch.size()) && syncFile(fileHandle);
+            if (ok) {
+                if (segmentBytes == FILE_HEADER_BYTES) segmentStarted = chrono::steady_clock::now();
+                segmentBytes += batch.size();
+            } else {
+                cerr << "Error: Could not write ride journal " << segmentPath(segment)
+                     << "; changes from now on are not saved" << endl;
+            }
+            batch.clear();
+
+            guard.lock();
+            if (ok) {
+                durable = upTo;
+                syncs++;
+            } else {
+                failed = true;
+            }
+            synced.notify_all();
+        }
+
+        // Seal when asked, when full, or when it has records and is old.
+        // A failed segment is never sealed, so no snapshot skips the loss.
+        bool full = segmentBytes >= SEGMENT_BYTES;
+        bool old = segmentBytes > FILE_HEADER_BYTES &&
+                   chrono::steady_clock::now() >= segmentStarted + SEGMENT_AGE;
+        if (failed && sealRequested) {
+            sealRequested = false;
+            sealed.notify_all();
+        } else if (!failed && (sealRequested || full || old)) {
+            sealRequested = false;
+            uint64_t finished = segment;
+            guard.unlock();
+            bool started = startSegment(finished + 1);
+            guard.lock();
+            // Otherwise keep appending to the old one
+            if (started) sealedUpTo = finished;
+            sealed.notify_all();
+        }
+
+        if (stopping && pending.empty()) break;
+    }
+}
+
+void RideJournal::checkpointLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        sealed.wait(guard, [this] { return stopping || sealedUpTo > foldTried; });
+        if (stopping) break;
+
+        uint64_t target = sealedUpTo;
+        guard.unlock();
+        bool ok = foldSegments(target);
+        guard.lock();
+
+        // On failure the segments stay, and the next seal tries again
+        if (ok) {
+            snapshotUpTo = target;
+            checkpoints++;
+        }
+        foldTried = target;
+        folded.notify_all();
+    }
+}
+
+bool RideJournal::foldSegments(uint64_t lastSegment) {
+    // Rebuilt from the files in a store of its own; the live one is untouched
+    RideStore scratch;
+    uint64_t covered = 0;
+    if (!loadSnapshot(snapshotPath(), scratch, covered)) {
+        cerr << "Error: Could not read ride snapshot " << snapshotPath() << endl;
+        return false;
+    }
+    vector<uint64_t> numbers = listSegments();
+    for (uint64_t number : numbers) {
+        if (number <= covered || number > lastSegment) continue;
+        uint64_t validBytes = 0;
+        size_t records = 0;
+        if (!replaySegment(segmentPath(number), scratch, validBytes, records)) return false;
+    }
+    if (!saveSnapshot(snapshotPath(), scratch, lastSegment)) {
+        cerr << "Error: Could not write ride snapshot " << snapshotPath() << endl;
+        return false;
+    }
+
+    for (uint64_t number : numbers) {
+        if (number > lastSegment) break;
+        error_code ec;
+        fs::remove(segmentPath(number), ec);
+    }
+    return true;
+}
+
+// Snapshot layout, host byte order:
+//   header | handle generations u32[handleCount] | free handle order
+//   u32[freeCount] | place names, each length u16 + bytes | rides, each
+//   handle index u32 | putRide() fields | pickup u32 | dropoff u32
+// Places are indexes into the name table, NO_PLACE for none.
+static const char SNAPSHOT_MAGIC[4] = {'G', 'R', 'S', 'N'};
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+static constexpr uint32_t NO_PLACE = 0xFFFFFFFFu;
+
+struct RideSnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t lastSegment;
+    uint32_t handleCount;
+    uint32_t freeCount;
+    uint32_t placeCount;
+    uint32_t rideCount;
+};
+
+bool RideJournal::saveSnapshot(const string& path, const RideStore& store, uint64_t lastSegment) {
+    vector<uint32_t> generations = store.handleGenerations();
+    const vector<uint32_t>& freeOrder = store.freeHandleOrder();
+
+    // Each place name once, however many rides use it
+    unordered_map<uint32_t, uint32_t> placeIndex;
+    vector<uint32_t> places;
+    auto placeOf = [&](uint32_t id) {
+        if (placeName(id).empty()) return NO_PLACE;
+        auto found = placeIndex.emplace(id, static_cast<uint32_t>(places.size()));
+        if (found.second) places.push_back(id);
+        return found.first->second;
+    };
+    for (const person& ride : store) {
+        placeOf(ride.pickup);
+        placeOf(ride.dropoff);
+    }
+
+    string temp = path + ".tmp";
+    intptr_t file = openForWrite(temp);
+    if (file == -1) return false;
+
+    RideSnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.lastSegment = lastSegment;
+    header.handleCount = static_cast<uint32_t>(generations.size());
+    header.freeCount = static_cast<uint32_t>(freeOrder.size());
+    header.placeCount = static_cast<uint32_t>(places.size());
+    header.rideCount = static_cast<uint32_t>(store.size());
+
+    // Written a megabyte at a time
+    string out(reinterpret_cast<const char*>(&header), sizeof(header));
+    bool ok = true;
+    auto flush = [&](size_t atLeast) {
+        if (out.size() < atLeast) return;
+        ok = ok && writeAll(file, out.data(), out.size());
+        out.clear();
+    };
+
+    out.append(reinterpret_cast<const char*>(generations.data()), generations.size() * sizeof(uint32_t));
+    out.append(reinterpret_cast<const char*>(freeOrder.data()), freeOrder.size() * sizeof(uint32_t));
+    for (uint32_t id : places) putText(out, placeName(id));
+    for (const person& ride : store) {
+        put(out, store.handleOf(ride).index);
+        putRide(out, ride);
+        put(out, placeOf(ride.pickup));
+        put(out, placeOf(ride.dropoff));
+        flush(1u << 20);
+    }
+    flush(0);
+
+    ok = ok && syncFile(file);
+    closeFile(file);
+    if (!ok) return false;
+
+    // Readers never see half a file, and a crash keeps one or the other
+    error_code ec;
+    fs::rename(temp, path, ec);
+    return !ec && syncDirectory(directoryOf(path));
+}
+
+bool RideJournal::loadSnapshot(const string& path, RideStore& store, uint64_t& lastSegment) {
+    lastSegment = 0;
+    error_code ec;
+    if (!fs::exists(path, ec)) return true;
+
+    MappedFile mapped;
+    RideSnapshotHeader header;
+    if (!mapped.open(path) || mapped.size() < sizeof(header)) return false;
+    memcpy(&header, mapped.data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SNAPSHOT_VERSION) return false;
+
+    RecordReader in{mapped.data() + sizeof(header), mapped.data() + mapped.size()};
+    vector<uint32_t> generations(header.handleCount), freeOrder(header.freeCount);
+    for (uint32_t& generation : generations) {
+        if (!in.get(generation)) return false;
+    }
+    for (uint32_t& handle : freeOrder) {
+        if (!in.get(handle)) return false;
+    }
+
+    // Names resolve against today's catalog once, not once per ride
+    const CityCatalog& cities = CityCatalog::instance();
+    vector<uint32_t> placeIds(header.placeCount);
+    for (uint32_t& id : placeIds) {
+        string_view name;
+        if (!in.getText(name)) return false;
+        id = placeId(cities, name);
+    }
+    auto cityOf = [&placeIds](uint32_t place) {
+        return (place < placeIds.size()) ? placeIds[place] : person::NO_CITY;
+    };
+
+    store.restoreHandles(generations, move(freeOrder));
+    store.reserve(header.rideCount);
+    for (uint32_t i = 0; i < header.rideCount; ++i) {
+        person ride;
+        uint32_t index, pickup, dropoff;
+        if (!in.get(index) || !getRide(in, ride) || !in.get(pickup) || !in.get(dropoff)) return false;
+        ride.pickup = cityOf(pickup);
+        ride.dropoff = cityOf(dropoff);
+        if (index >= generations.size() || !store.addAt({index, generations[index]}, move(ride))) return false;
+    }
+
+    // Anything left over means the counts and the contents disagree
+    if (in.at != in.end) return false;
+    lastSegment = header.lastSegment;
+    return true;
+}
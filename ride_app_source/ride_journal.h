@@ -0,0 +1,127 @@
+#ifndef RIDE_JOURNAL_H
+#define RIDE_JOURNAL_H
+
+#include "ride_store.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Append-only log of every change to the rides, so they survive a restart
+// or a crash. Each record is the full ride after a booking or edit, or the
+// handle of a deleted ride; replaying them in order rebuilds the store
+// with the same handles.
+//
+// Appends only copy the record into a buffer. A writer thread writes
+// whatever has collected and syncs it to disk in one go, so a burst of
+// bookings costs one fsync, not one each. Call waitDurable() before
+// telling the user a change is saved. If a write or sync fails, the
+// journal stops writing and waitDurable() returns false from then on,
+// since records after a lost batch could not be replayed correctly.
+//
+// The log is split into segments, <base>-000001.journal and so on. Once a
+// segment is full or old enough it is sealed, and a checkpoint thread
+// folds the sealed segments into <base>.snapshot and deletes them. It
+// works from the files, not the live store, so bookings never wait for
+// it. Startup loads the snapshot and replays only the segments after it.
+class RideJournal {
+public:
+    // A segment is sealed at this size, or this long after its first record
+    static constexpr uint64_t SEGMENT_BYTES = 16u << 20;
+    static constexpr std::chrono::seconds SEGMENT_AGE{600};
+
+    RideJournal() = default;
+    ~RideJournal();
+    RideJournal(const RideJournal&) = delete;
+    RideJournal& operator=(const RideJournal&) = delete;
+
+    // Load the snapshot and replay the journal at base into store, then
+    // start a new segment for appending. A torn record left by a crash ends
+    // the replay and is cut off. False if the files cannot be read or
+    // written; store is left empty and no file is deleted then.
+    bool open(const std::string& base, RideStore& store);
+    // Write out everything appended and stop the threads. A checkpoint in
+    // progress is finished first.
+    void close();
+    bool isOpen() const { return writer.joinable(); }
+
+    // Queue a record of a ride as it is now, or of its deletion.
+    // Returns the record's sequence number.
+    uint64_t recordPut(RideHandle handle, const person& ride);
+    uint64_t recordErase(RideHandle handle);
+
+    // Block until record sequence (default: everything so far) is on disk.
+    // False if it never will be, because a write failed.
+    bool waitDurable(uint64_t sequence);
+    bool waitDurable();
+
+    // Seal the current segment and wait until a snapshot covers it.
+    // False if either step failed; the segments are kept then.
+    bool checkpoint();
+
+    // What open() found: rides from the snapshot, and records replayed after it
+    size_t restoredCount() const { return restored; }
+    size_t replayedCount() const { return replayed; }
+    // Records appended since open(), syncs done, and snapshots written
+    uint64_t appendedCount() const;
+    uint64_t syncCount() const;
+    uint64_t checkpointCount() const;
+
+    // Snapshot of store covering segments up to lastSegment, written beside
+    // path and renamed into place
+    static bool saveSnapshot(const std::string& path, const RideStore& store, uint64_t lastSegment);
+    // Load a snapshot into an empty store. True with lastSegment 0 if
+    // there is no snapshot; false if there is one that cannot be read.
+    static bool loadSnapshot(const std::string& path, RideStore& store, uint64_t& lastSegment);
+
+private:
+    std::string segmentPath(uint64_t segment) const;
+    std::string snapshotPath() const;
+    // Numbers of the segment files that exist, in order
+    std::vector<uint64_t> listSegments() const;
+    // Apply one segment to store. False if the file is not a ride journal.
+    static bool replaySegment(const std::string& path, RideStore& store, uint64_t& validBytes, size_t& records);
+    bool startSegment(uint64_t segment);
+    // Build a snapshot covering segments up to lastSegment and delete them
+    bool foldSegments(uint64_t lastSegment);
+
+    uint64_t append(const std::string& record);
+    void writerLoop();
+    void checkpointLoop();
+
+    std::string base;
+    size_t restored = 0;
+    size_t replayed = 0;
+    intptr_t fileHandle = -1;   // fd, or a HANDLE on Windows
+
+    mutable std::mutex lock;
+    std::condition_variable wake;        // the writer: records are waiting
+    std::condition_variable synced;      // appenders: durable moved on
+    std::condition_variable sealed;      // the checkpoint thread: a segment was sealed
+    std::condition_variable folded;      // checkpoint(): a snapshot was written
+    std::string pending;
+    uint64_t appended = 0;
+    uint64_t durable = 0;
+    uint64_t syncs = 0;
+    bool stopping = false;
+    bool failed = false;                 // a batch could not be written
+
+    // Owned by the writer
+    uint64_t segment = 0;
+    uint64_t segmentBytes = 0;
+    std::chrono::steady_clock::time_point segmentStarted;
+
+    bool sealRequested = false;
+    uint64_t sealedUpTo = 0;        // newest segment that will not grow
+    uint64_t snapshotUpTo = 0;      // newest segment in the snapshot
+    uint64_t foldTried = 0;         // newest segment a checkpoint was attempted for
+    uint64_t checkpoints = 0;
+
+    std::thread writer;
+    std::thread checkpointer;
+};
+
+#endif // RIDE_JOURNAL_H
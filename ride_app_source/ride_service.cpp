@@ -0,0 +1,123 @@
+#include "ride_service.h"
+#include "distance_matrix.h"
+#include "rail_lines.h"
+#include "transit_router.h"
+#include <ctime>
+
+using namespace std;
+
+string RideService::newRideId() {
+    static uint64_t sequence = 0;
+    return to_string(static_cast<long long>(time(nullptr))) + "_" + to_string(sequence++);
+}
+
+const VehicleRate* RideService::rateFor(VehicleType vehicle) {
+    // The table is keyed by name; look each type up once
+    static const vector<const VehicleRate*> rates = [] {
+        vector<const VehicleRate*> byType(VEHICLE_TYPE_COUNT, nullptr);
+        for (size_t i = 0; i < VEHICLE_TYPE_COUNT; ++i) {
+            auto found = DistanceCalculator::VEHICLE_RATES.find(vehicleName(static_cast<VehicleType>(i)));
+            if (found != DistanceCalculator::VEHICLE_RATES.end()) byType[i] = &found->second;
+        }
+        return byType;
+    }();
+    return rates[static_cast<size_t>(vehicle)];
+}
+
+bool RideService::quoteFare(const person& ride, double& km, double& fare) {
+    const City& fromCity = ride.pickupCity();
+    const City& toCity = ride.dropoffCity();
+
+    km = DistanceMatrix::instance().distance(fromCity, toCity);
+    if (ride.vehicle == VehicleType::Train) {
+        double track = RailLines::instance().trackDistance(fromCity, toCity);
+        if (track >= 0) {
+            km = track;
+        } else {
+            TransitRouter::Route route = TransitRouter::instance().route(fromCity, toCity);
+            if (route.found) km = route.km;
+        }
+    }
+
+    const VehicleRate* rate = rateFor(ride.vehicle);
+    if (!rate) return false;
+    fare = rate->baseFare + rate->perKmRate * km;
+    return true;
+}
+
+Driver* RideService::assignDriver(person& ride, double* driverKm) {
+    const City& fromCity = ride.pickupCity();
+    Driver* driver = drivers.assignNearestDriver(vehicleName(ride.vehicle), fromCity.lat, fromCity.lon, driverKm);
+    ride.assignedDriverId = driver ? driver->id : -1;
+    return driver;
+}
+
+RideService::Booking RideService::book(person ride) {
+    Booking booking;
+    ride.status = RideStatus::Pending;
+    assignDriver(ride, &booking.driverKm);
+    quoteFare(ride, booking.routeKm, ride.totalFare);
+    booking.handle = rides.add(move(ride));
+    return booking;
+}
+
+RideService::Outcome RideService::cancel(RideHandle handle) {
+    const person* ride = rides.get(handle);
+    if (!ride) return Outcome::NotFound;
+    if (ride->status == RideStatus::Completed) return Outcome::Completed;
+    if (ride->status == RideStatus::Canceled) return Outcome::AlreadyCanceled;
+
+    int driverId = ride->assignedDriverId;
+    rides.update(handle, [](person& stored) { stored.status = RideStatus::Canceled; });
+    if (driverId != -1) drivers.releaseDriver(driverId);
+    return Outcome::Done;
+}
+
+RideService::Outcome RideService::remove(RideHandle handle) {
+    const person* ride = rides.get(handle);
+    if (!ride) return Outcome::NotFound;
+
+    bool active = ride->status == RideStatus::Pending || ride->status == RideStatus::Confirmed ||
+                  ride->status == RideStatus::OnRide;
+    int driverId = ride->assignedDriverId;
+    rides.erase(handle);
+    if (active && driverId != -1) drivers.releaseDriver(driverId);
+    return Outcome::Done;
+}
+
+RideService::Dispatch RideService::dispatchPending(int day, int month, int year) {
+    Dispatch dispatch;
+    vector<BatchDispatcher::Request> requests;
+
+    for (RideHandle handle : rides.withStatus(RideStatus::Pending, day, month, year)) {
+        const person& ride = *rides.get(handle);
+        const City& fromCity = ride.pickupCity();
+
+        if (ride.assignedDriverId != -1) {
+            drivers.releaseDriver(ride.assignedDriverId);
+            rides.update(handle, [](person& stored) { stored.assignedDriverId = -1; });
+        }
+        dispatch.rides.push_back(handle);
+        requests.push_back({vehicleName(ride.vehicle), fromCity.lat, fromCity.lon});
+    }
+    if (dispatch.rides.empty()) return dispatch;
+
+    BatchDispatcher dispatcher(drivers);
+    dispatch.result = dispatcher.dispatch(requests);
+    for (size_t i = 0; i < dispatch.rides.size(); ++i) {
+        int driverId = dispatch.result.driverIds[i];
+        rides.update(dispatch.rides[i], [driverId](person& stored) { stored.assignedDriverId = driverId; });
+    }
+    return dispatch;
+}
+
+const char* RideService::describe(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::Done: return "done";
+        case Outcome::NotFound: return "ride not found";
+        case Outcome::NotPending: return "only pending rides can be changed";
+        case Outcome::Completed: return "completed rides cannot be canceled";
+        case Outcome::AlreadyCanceled: return "ride is already canceled";
+    }
+    return "";
+}
@@ -0,0 +1,83 @@
+#ifndef RIDE_SERVICE_H
+#define RIDE_SERVICE_H
+
+#include "batch_dispatcher.h"
+#include "distance_calculator.h"
+#include "driver_manager.h"
+#include "ride_store.h"
+#include <string>
+#include <vector>
+
+// The booking rules behind both the menus and the command mode: fares,
+// which driver a ride gets and when it is handed back, and which rides
+// may be edited or canceled. Nothing here prompts or prints.
+class RideService {
+public:
+    enum class Outcome { Done, NotFound, NotPending, Completed, AlreadyCanceled };
+
+    struct Booking {
+        RideHandle handle;
+        double driverKm = -1;   // -1 if no driver, or its position is unknown
+        double routeKm = 0;
+    };
+
+    struct Dispatch {
+        std::vector<RideHandle> rides;      // in the order of result's entries
+        BatchDispatcher::Result result;
+    };
+
+    RideService(RideStore& rides, DriverManager& drivers) : rides(rides), drivers(drivers) {}
+
+    // A ride id no other booking in this run gets
+    static std::string newRideId();
+
+    // Rate for a vehicle type, nullptr if the fare table lacks it
+    static const VehicleRate* rateFor(VehicleType vehicle);
+    // Route length and fare for the ride's vehicle; trains are charged for
+    // the track actually travelled. False if the vehicle has no rate.
+    static bool quoteFare(const person& ride, double& km, double& fare);
+
+    // Give the ride the nearest free driver of its vehicle type to the
+    // pickup, or none (-1). driverKm as for assignNearestDriver().
+    Driver* assignDriver(person& ride, double* driverKm = nullptr);
+
+    // Store the ride as pending, with a driver and its fare
+    Booking book(person ride);
+
+    // Change a pending ride and quote its fare again. A new vehicle type or
+    // pickup gets the nearest free driver for it, releasing any old one.
+    template <typename Change>
+    Outcome edit(RideHandle handle, Change change) {
+        const person* ride = rides.get(handle);
+        if (!ride) return Outcome::NotFound;
+        if (ride->status != RideStatus::Pending) return Outcome::NotPending;
+        VehicleType vehicle = ride->vehicle;
+        uint32_t pickup = ride->pickup;
+        rides.update(handle, [&](person& stored) {
+            change(stored);
+            double km;
+            quoteFare(stored, km, stored.totalFare);
+            if (stored.vehicle != vehicle || stored.pickup != pickup) {
+                if (stored.assignedDriverId != -1) drivers.releaseDriver(stored.assignedDriverId);
+                assignDriver(stored);
+            }
+        });
+        return Outcome::Done;
+    }
+
+    // Cancel a ride that has not finished, freeing its driver
+    Outcome cancel(RideHandle handle);
+    // Delete a ride, freeing its driver if the ride was still active
+    Outcome remove(RideHandle handle);
+
+    // Match every pending ride on this date to drivers in one batch. Drivers
+    // picked at booking time go back in the pool first.
+    Dispatch dispatchPending(int day, int month, int year);
+
+    static const char* describe(Outcome outcome);
+
+    RideStore& rides;
+    DriverManager& drivers;
+};
+
+#endif // RIDE_SERVICE_H
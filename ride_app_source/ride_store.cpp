@@ -0,0 +1,359 @@
+#include "ride_store.h"
+#include "ride_journal.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+const char* statusName(RideStatus status) {
+    static const char* NAMES[RIDE_STATUS_COUNT] = {"Pending", "Confirmed", "OnRide", "Completed", "Canceled"};
+    return NAMES[static_cast<size_t>(status)];
+}
+
+const char* vehicleName(VehicleType vehicle) {
+    static const char* NAMES[VEHICLE_TYPE_COUNT] = {"Sedan", "SUV", "Truck", "Van", "Motorcycle", "Bus", "Train"};
+    return NAMES[static_cast<size_t>(vehicle)];
+}
+
+bool vehicleFromName(string_view name, VehicleType& vehicle) {
+    for (size_t i = 0; i < VEHICLE_TYPE_COUNT; ++i) {
+        const char* candidate = vehicleName(static_cast<VehicleType>(i));
+        if (name.size() != strlen(candidate)) continue;
+        bool same = true;
+        for (size_t c = 0; c < name.size() && same; ++c) {
+            same = tolower(static_cast<unsigned char>(name[c])) == tolower(static_cast<unsigned char>(candidate[c]));
+        }
+        if (same) {
+            vehicle = static_cast<VehicleType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+ostream& operator<<(ostream& out, RideStatus status) {
+    return out << statusName(status);
+}
+
+ostream& operator<<(ostream& out, VehicleType vehicle) {
+    return out << vehicleName(vehicle);
+}
+
+const City& person::cityAt(uint32_t id) {
+    static const City UNKNOWN = {"(unknown place)", 0.0, 0.0};
+    const vector<City>& cities = CityCatalog::instance().cities();
+    return (id < cities.size()) ? cities[id] : UNKNOWN;
+}
+
+string RideStore::fold(string_view text) {
+    string folded(text);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return folded;
+}
+
+void RideStore::addTo(HandleList& list, uint32_t handle, uint32_t ListSlots::*slot) {
+    listSlots[handle].*slot = static_cast<uint32_t>(list.size());
+    list.push_back(handle);
+}
+
+void RideStore::removeFrom(HandleList& list, uint32_t handle, uint32_t ListSlots::*slot) {
+    uint32_t at = listSlots[handle].*slot;
+    uint32_t moved = list.back();
+    list[at] = moved;
+    listSlots[moved].*slot = at;
+    list.pop_back();
+}
+
+void RideStore::appendInBookingOrder(const HandleList& list, vector<RideHandle>& found) const {
+    size_t first = found.size();
+    for (uint32_t handle : list) found.push_back(handleFor(handle));
+    sort(found.begin() + first, found.end(), [this](RideHandle a, RideHandle b) {
+        return handles[a.index].position < handles[b.index].position;
+    });
+}
+
+void RideStore::LengthCounts::add(size_t length) {
+    if (length >= counts.size()) counts.resize(length + 1);
+    counts[length]++;
+    longest = max(longest, length);
+}
+
+void RideStore::LengthCounts::remove(size_t length) {
+    counts[length]--;
+    while (longest > 0 && counts[longest] == 0) --longest;
+}
+
+// Characters in the yyyy-mm-dd form of the ride's date
+static size_t dateLength(const person& ride) {
+    size_t digits = 1;
+    for (uint32_t year = ride.rideYear; year >= 10; year /= 10) ++digits;
+    return digits + 6;
+}
+
+void RideStore::journalPut(RideHandle handle) const {
+    journal->recordPut(handle, rides[handles[handle.index].position]);
+}
+
+void RideStore::index(uint32_t handle) {
+    const person& ride = rides[handles[handle].position];
+    byId.emplace(ride.ride_id, handle);
+    addTo(byFirstName[fold(ride.fname)], handle, &ListSlots::firstName);
+    addTo(byLastName[fold(ride.lname)], handle, &ListSlots::lastName);
+    StatusBucket& bucket = byStatus[static_cast<size_t>(ride.status)];
+    addTo(bucket.byDate[ride.dateKey()], handle, &ListSlots::statusDate);
+    bucket.count++;
+
+    vehicleCounts[static_cast<size_t>(ride.vehicle)]++;
+    textLengths[RideIdColumn].add(ride.ride_id.size());
+    textLengths[FirstNameColumn].add(ride.fname.size());
+    textLengths[LastNameColumn].add(ride.lname.size());
+    textLengths[PhoneColumn].add(ride.phone.size());
+    textLengths[PickupColumn].add(ride.pickupCity().name.size());
+    textLengths[DropoffColumn].add(ride.dropoffCity().name.size());
+    textLengths[DateColumn].add(dateLength(ride));
+}
+
+void RideStore::unindex(uint32_t handle) {
+    const person& ride = rides[handles[handle].position];
+    auto ids = byId.equal_range(ride.ride_id);
+    for (auto it = ids.first; it != ids.second; ++it) {
+        if (it->second == handle) {
+            byId.erase(it);
+            break;
+        }
+    }
+    auto firsts = byFirstName.find(fold(ride.fname));
+    removeFrom(firsts->second, handle, &ListSlots::firstName);
+    if (firsts->second.empty()) byFirstName.erase(firsts);
+
+    auto lasts = byLastName.find(fold(ride.lname));
+    removeFrom(lasts->second, handle, &ListSlots::lastName);
+    if (lasts->second.empty()) byLastName.erase(lasts);
+
+    StatusBucket& bucket = byStatus[static_cast<size_t>(ride.status)];
+    auto onDate = bucket.byDate.find(ride.dateKey());
+    removeFrom(onDate->second, handle, &ListSlots::statusDate);
+    if (onDate->second.empty()) bucket.byDate.erase(onDate);
+    bucket.count--;
+
+    vehicleCounts[static_cast<size_t>(ride.vehicle)]--;
+    textLengths[RideIdColumn].remove(ride.ride_id.size());
+    textLengths[FirstNameColumn].remove(ride.fname.size());
+    textLengths[LastNameColumn].remove(ride.lname.size());
+    textLengths[PhoneColumn].remove(ride.phone.size());
+    textLengths[PickupColumn].remove(ride.pickupCity().name.size());
+    textLengths[DropoffColumn].remove(ride.dropoffCity().name.size());
+    textLengths[DateColumn].remove(dateLength(ride));
+}
+
+void RideStore::reserve(size_t count) {
+    rides.reserve(count);
+    live.reserve(count);
+    handleAt.reserve(count);
+    handles.reserve(count);
+    listSlots.reserve(count);
+    byId.reserve(count);
+}
+
+RideHandle RideStore::add(person ride) {
+    uint32_t handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<uint32_t>(handles.size());
+        handles.push_back({0, 0});
+        listSlots.push_back({});
+    }
+
+    place(handle, move(ride));
+    if (journal) journalPut(handleFor(handle));
+    return handleFor(handle);
+}
+
+void RideStore::place(uint32_t handle, person&& ride) {
+    handles[handle].position = static_cast<uint32_t>(rides.size());
+    if (rides.size() % BLOCK_RIDES == 0) liveInBlock.push_back(0);
+    liveInBlock[rides.size() / BLOCK_RIDES]++;
+    rides.push_back(move(ride));
+    live.push_back(1);
+    handleAt.push_back(handle);
+    liveCount++;
+    index(handle);
+}
+
+vector<uint32_t> RideStore::handleGenerations() const {
+    vector<uint32_t> generations;
+    generations.reserve(handles.size());
+    for (const HandleSlot& slot : handles) generations.push_back(slot.generation);
+    return generations;
+}
+
+void RideStore::restoreHandles(vector<uint32_t> generations, vector<uint32_t> freeOrder) {
+    handles.clear();
+    handles.reserve(generations.size());
+    for (uint32_t generation : generations) handles.push_back({HandleSlot::UNPLACED, generation});
+    listSlots.assign(generations.size(), ListSlots());
+    freeHandles = move(freeOrder);
+}
+
+bool RideStore::addAt(RideHandle handle, person ride) {
+    if (handle.index >= handles.size()) return false;
+    HandleSlot& slot = handles[handle.index];
+    if (slot.position != HandleSlot::UNPLACED || slot.generation != handle.generation) return false;
+    place(handle.index, move(ride));
+    return true;
+}
+
+bool RideStore::erase(RideHandle handle) {
+    if (!get(handle)) return false;
+
+    unindex(handle.index);
+    if (journal) journal->recordErase(handle);
+    HandleSlot& slot = handles[handle.index];
+    live[slot.position] = 0;
+    liveInBlock[slot.position / BLOCK_RIDES]--;
+    rides[slot.position] = person();    // free its strings now
+    // Old handles to this slot stop resolving
+    slot.generation++;
+    freeHandles.push_back(handle.index);
+    liveCount--;
+
+    size_t dead = rides.size() - liveCount;
+    if (dead > 64 && dead > liveCount) compact();
+    return true;
+}
+
+void RideStore::compact() {
+    size_t out = 0;
+    for (size_t position = 0; position < rides.size(); ++position) {
+        if (!live[position]) continue;
+        if (out != position) {
+            rides[out] = move(rides[position]);
+            handleAt[out] = handleAt[position];
+        }
+        live[out] = 1;
+        handles[handleAt[out]].position = static_cast<uint32_t>(out);
+        ++out;
+    }
+    rides.resize(out);
+    live.resize(out);
+    handleAt.resize(out);
+
+    // Every block but the last is full now
+    liveInBlock.assign((out + BLOCK_RIDES - 1) / BLOCK_RIDES, static_cast<uint32_t>(BLOCK_RIDES));
+    if (out % BLOCK_RIDES) liveInBlock.back() = static_cast<uint32_t>(out % BLOCK_RIDES);
+}
+
+RideStore::const_iterator RideStore::atRow(size_t row) const {
+    if (row >= liveCount) return end();
+    if (liveCount == rides.size()) return const_iterator(this, row);
+
+    size_t block = 0;
+    while (row >= liveInBlock[block]) row -= liveInBlock[block++];
+    size_t position = block * BLOCK_RIDES;
+    for (;; ++position) {
+        if (live[position] && row-- == 0) break;
+    }
+    return const_iterator(this, position);
+}
+
+const person* RideStore::get(RideHandle handle) const {
+    if (handle.index >= handles.size()) return nullptr;
+    const HandleSlot& slot = handles[handle.index];
+    if (slot.generation != handle.generation || slot.position >= rides.size() ||
+        !live[slot.position] || handleAt[slot.position] != handle.index) {
+        return nullptr;
+    }
+    return &rides[slot.position];
+}
+
+RideHandle RideStore::handleOf(const person& ride) const {
+    size_t position = static_cast<size_t>(&ride - rides.data());
+    if (position >= rides.size() || !live[position]) return RideHandle();
+    return handleFor(handleAt[position]);
+}
+
+RideHandle RideStore::findById(const string& rideId) const {
+    // Earliest booking among rides sharing the id
+    auto ids = byId.equal_range(rideId);
+    uint32_t first = RideHandle::NONE;
+    for (auto it = ids.first; it != ids.second; ++it) {
+        if (first == RideHandle::NONE || handles[it->second].position < handles[first].position) first = it->second;
+    }
+    return (first != RideHandle::NONE) ? handleFor(first) : RideHandle();
+}
+
+vector<RideHandle> RideStore::findByFirstName(string_view first) const {
+    vector<RideHandle> found;
+    auto it = byFirstName.find(fold(first));
+    if (it == byFirstName.end()) return found;
+    appendInBookingOrder(it->second, found);
+    return found;
+}
+
+vector<RideHandle> RideStore::findByName(string_view first, string_view last) const {
+    vector<RideHandle> found;
+    auto firsts = byFirstName.find(fold(first));
+    auto lasts = byLastName.find(fold(last));
+    if (firsts == byFirstName.end() || lasts == byLastName.end()) return found;
+
+    // Walk the shorter list, check the other field directly
+    bool byFirst = firsts->second.size() <= lasts->second.size();
+    const string key = fold(byFirst ? last : first);
+    HandleList matches;
+    for (uint32_t handle : (byFirst ? firsts : lasts)->second) {
+        const person& ride = rides[handles[handle].position];
+        const string& other = byFirst ? ride.lname : ride.fname;
+        if (other.size() == key.size() && fold(other) == key) matches.push_back(handle);
+    }
+    appendInBookingOrder(matches, found);
+    return found;
+}
+
+vector<RideHandle> RideStore::withStatus(RideStatus status) const {
+    vector<RideHandle> found;
+    const StatusBucket& bucket = byStatus[static_cast<size_t>(status)];
+    found.reserve(bucket.count);
+    for (const auto& day : bucket.byDate) appendInBookingOrder(day.second, found);
+    return found;
+}
+
+vector<RideHandle> RideStore::withStatus(RideStatus status, int day, int month, int year) const {
+    vector<RideHandle> found;
+    const StatusBucket& bucket = byStatus[static_cast<size_t>(status)];
+    auto onDate = bucket.byDate.find(year * 10000 + month * 100 + day);
+    if (onDate == bucket.byDate.end()) return found;
+    appendInBookingOrder(onDate->second, found);
+    return found;
+}
+
+size_t RideStore::countWithStatus(RideStatus status) const {
+    return byStatus[static_cast<size_t>(status)].count;
+}
+
+size_t RideStore::countWithVehicle(VehicleType vehicle) const {
+    return vehicleCounts[static_cast<size_t>(vehicle)];
+}
+
+RideStore::ColumnWidths RideStore::columnWidths() const {
+    ColumnWidths widths;
+    widths.rideId = textLengths[RideIdColumn].longest;
+    widths.firstName = textLengths[FirstNameColumn].longest;
+    widths.lastName = textLengths[LastNameColumn].longest;
+    widths.phone = textLengths[PhoneColumn].longest;
+    widths.pickup = textLengths[PickupColumn].longest;
+    widths.dropoff = textLengths[DropoffColumn].longest;
+    widths.date = textLengths[DateColumn].longest;
+    // A handful of types each, so check which are in use
+    for (size_t i = 0; i < VEHICLE_TYPE_COUNT; ++i) {
+        if (vehicleCounts[i]) widths.vehicle = max(widths.vehicle, strlen(vehicleName(static_cast<VehicleType>(i))));
+    }
+    for (size_t i = 0; i < RIDE_STATUS_COUNT; ++i) {
+        if (byStatus[i].count) widths.status = max(widths.status, strlen(statusName(static_cast<RideStatus>(i))));
+    }
+    return widths;
+}
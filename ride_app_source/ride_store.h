@@ -0,0 +1,255 @@
+#ifndef RIDE_STORE_H
+#define RIDE_STORE_H
+
+#include "city_catalog.h"
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Where a ride is in its life
+enum class RideStatus : uint8_t { Pending, Confirmed, OnRide, Completed, Canceled };
+constexpr size_t RIDE_STATUS_COUNT = 5;
+
+// Vehicle types a ride can be booked on, in menu order
+enum class VehicleType : uint8_t { Sedan, SUV, Truck, Van, Motorcycle, Bus, Train };
+constexpr size_t VEHICLE_TYPE_COUNT = 7;
+
+// Display names, as used by the fare table and the driver roster
+const char* statusName(RideStatus status);
+const char* vehicleName(VehicleType vehicle);
+// The vehicle with this display name, any case; false if there is none
+bool vehicleFromName(std::string_view name, VehicleType& vehicle);
+std::ostream& operator<<(std::ostream& out, RideStatus status);
+std::ostream& operator<<(std::ostream& out, VehicleType vehicle);
+
+// One booked ride. Status and vehicle are one-byte enums, places are
+// CityCatalog ids and the date is packed into 32 bits, so status and date
+// checks compare integers and only the rider's own details are strings.
+struct person {
+    static constexpr uint32_t NO_CITY = 0xFFFFFFFFu;
+
+    std::string ride_id; 
+    std::string fname;
+    std::string lname;
+    std::string phone;
+    double totalFare = 0;
+    int32_t assignedDriverId = -1; 
+    uint32_t pickup = NO_CITY;      // ids into CityCatalog::cities()
+    uint32_t dropoff = NO_CITY;
+    uint32_t rideDay : 5;
+    uint32_t rideMonth : 4;
+    uint32_t rideYear : 23;
+    uint16_t num_of_persons = 1;
+    RideStatus status = RideStatus::Pending;
+    VehicleType vehicle = VehicleType::Sedan;
+    bool isCurrentRide = false;
+
+    person() : rideDay(1), rideMonth(1), rideYear(1970) {}
+
+    const City& pickupCity() const { return cityAt(pickup); }
+    const City& dropoffCity() const { return cityAt(dropoff); }
+    // The catalog city, or a placeholder for NO_CITY
+    static const City& cityAt(uint32_t id);
+
+    void setDate(int day, int month, int year) {
+        rideDay = static_cast<uint32_t>(day);
+        rideMonth = static_cast<uint32_t>(month);
+        rideYear = static_cast<uint32_t>(year);
+    }
+    // yyyymmdd, which sorts by date
+    int dateKey() const { return static_cast<int>(rideYear * 10000 + rideMonth * 100 + rideDay); }
+};
+
+class RideJournal;
+
+// Names a ride in a RideStore. Handles stay valid while other rides are
+// added or deleted; once their own ride is deleted they resolve to nothing.
+struct RideHandle {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    uint32_t index = NONE;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != NONE; }
+};
+
+// All booked rides, in booking order, in one contiguous array. Hash
+// indexes on ride id and on case-folded first and last name, and per-status
+// buckets ordered by ride date, replace scans of the whole list.
+//
+// Iteration is read-only; change rides through update() so the indexes
+// follow. With a journal attached, every add, update and erase is also
+// recorded there.
+class RideStore {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = person;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const person*;
+        using reference = const person&;
+
+        const_iterator(const RideStore* store, size_t position) : store(store), position(position) { skipDead(); }
+        reference operator*() const { return store->rides[position]; }
+        pointer operator->() const { return &store->rides[position]; }
+        const_iterator& operator++() { ++position; skipDead(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+
+    private:
+        void skipDead() { while (position < store->rides.size() && !store->live[position]) ++position; }
+        const RideStore* store;
+        size_t position;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, rides.size()); }
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+
+    // Iterator at the row-th ride in booking order (0-based), end() if
+    // there are not that many. Skips whole blocks of rides by their live
+    // counts, so a page deep in the table is found without walking to it.
+    const_iterator atRow(size_t row) const;
+
+    RideHandle add(person ride);
+
+    // Delete a ride; false if the handle no longer names one
+    bool erase(RideHandle handle);
+
+    // The ride a handle names, nullptr if it was deleted
+    const person* get(RideHandle handle) const;
+
+    // Handle of a ride reached by iterating the store
+    RideHandle handleOf(const person& ride) const;
+
+    // Apply change(person&) to a ride and re-index it
+    template <typename Change>
+    bool update(RideHandle handle, Change change) {
+        person* ride = const_cast<person*>(get(handle));
+        if (!ride) return false;
+        unindex(handle.index);
+        change(*ride);
+        index(handle.index);
+        if (journal) journalPut(handle);
+        return true;
+    }
+
+    // First ride with this id. RideService::newRideId() never repeats within
+    // a run, but ids given in headless commands, or made by two runs started
+    // in the same second, can.
+    RideHandle findById(const std::string& rideId) const;
+
+    // Rides whose first name, or first and last name, match ignoring case
+    std::vector<RideHandle> findByFirstName(std::string_view first) const;
+    std::vector<RideHandle> findByName(std::string_view first, std::string_view last) const;
+
+    // Rides with this status, by ride date, or only those on one date
+    std::vector<RideHandle> withStatus(RideStatus status) const;
+    std::vector<RideHandle> withStatus(RideStatus status, int day, int month, int year) const;
+    size_t countWithStatus(RideStatus status) const;
+    size_t countWithVehicle(VehicleType vehicle) const;
+
+    // Longest value in each column of the ride table, over every ride.
+    // Kept up to date as rides are added, changed and deleted, so a table
+    // can be sized without reading the rides.
+    struct ColumnWidths {
+        size_t rideId = 0, firstName = 0, lastName = 0, phone = 0;
+        size_t pickup = 0, dropoff = 0, date = 0, vehicle = 0, status = 0;
+    };
+    ColumnWidths columnWidths() const;
+
+    // Reserve room for count rides
+    void reserve(size_t count);
+    // Drop every ride and handle, back to a new, detached store
+    void clear() { *this = RideStore(); }
+
+    // Record later changes in journal (nullptr to stop). Attach after the
+    // journal has replayed into this store.
+    void attach(RideJournal* journal) { this->journal = journal; }
+
+    // Handle bookkeeping, so a snapshot can rebuild the store exactly and
+    // later journal records still name the right rides. Restoring needs
+    // an empty store: restoreHandles() first, then addAt() for each ride.
+    std::vector<uint32_t> handleGenerations() const;
+    const std::vector<uint32_t>& freeHandleOrder() const { return freeHandles; }
+    void restoreHandles(std::vector<uint32_t> generations, std::vector<uint32_t> freeOrder);
+    bool addAt(RideHandle handle, person ride);
+
+private:
+    struct HandleSlot {
+        static constexpr uint32_t UNPLACED = 0xFFFFFFFFu;
+        uint32_t position;      // index into rides
+        uint32_t generation;
+    };
+    // Where a ride sits in each of its index lists, so it can be taken
+    // out without searching a list that may hold every ride
+    struct ListSlots {
+        uint32_t firstName = 0;
+        uint32_t lastName = 0;
+        uint32_t statusDate = 0;
+    };
+    using HandleList = std::vector<uint32_t>;
+    struct StatusBucket {
+        size_t count = 0;
+        std::map<int, HandleList> byDate;    // yyyymmdd -> handles
+    };
+    using NameLists = std::unordered_map<std::string, HandleList>;   // lowercased name -> handles
+    // How many rides have a value of each length, so the longest is still
+    // known after the longest one is deleted
+    struct LengthCounts {
+        std::vector<uint32_t> counts;
+        size_t longest = 0;
+
+        void add(size_t length);
+        void remove(size_t length);
+    };
+    enum TextColumn { RideIdColumn, FirstNameColumn, LastNameColumn, PhoneColumn, PickupColumn, DropoffColumn,
+                      DateColumn, TEXT_COLUMN_COUNT };
+
+    static std::string fold(std::string_view text);
+    // Lists are unordered: removal moves the last handle into the gap
+    void addTo(HandleList& list, uint32_t handle, uint32_t ListSlots::*slot);
+    void removeFrom(HandleList& list, uint32_t handle, uint32_t ListSlots::*slot);
+    // Append a list's rides to found in booking order
+    void appendInBookingOrder(const HandleList& list, std::vector<RideHandle>& found) const;
+    RideHandle handleFor(uint32_t index) const { return {index, handles[index].generation}; }
+
+    void journalPut(RideHandle handle) const;
+    void place(uint32_t handle, person&& ride);
+    void index(uint32_t handle);
+    void unindex(uint32_t handle);
+    // Squeeze out deleted rides once they outnumber live ones
+    void compact();
+
+    // Positions per block counted in liveInBlock
+    static constexpr size_t BLOCK_RIDES = 1024;
+
+    // Dense, in booking order; deleted rides leave a dead slot until compact()
+    std::vector<person> rides;
+    std::vector<char> live;
+    std::vector<uint32_t> liveInBlock;
+    std::vector<uint32_t> handleAt;     // per position
+    std::vector<HandleSlot> handles;
+    std::vector<ListSlots> listSlots;   // per handle
+    std::vector<uint32_t> freeHandles;
+    size_t liveCount = 0;
+
+    // A multimap, since ids can repeat across runs or be given by a command
+    std::unordered_multimap<std::string, uint32_t> byId;
+    NameLists byFirstName;
+    NameLists byLastName;
+    StatusBucket byStatus[RIDE_STATUS_COUNT];
+    size_t vehicleCounts[VEHICLE_TYPE_COUNT] = {};
+    LengthCounts textLengths[TEXT_COLUMN_COUNT];
+
+    RideJournal* journal = nullptr;
+};
+
+#endif // RIDE_STORE_H
@@ -0,0 +1,117 @@
+#include "ride_table.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+using namespace std;
+
+// Rows are written out whenever this much has collected
+static constexpr size_t WRITE_BYTES = 64 * 1024;
+
+enum Column { RideId, FirstName, LastName, Phone, Pickup, Dropoff, Date, Vehicle, Status, COLUMN_COUNT };
+static const char* const TITLES[COLUMN_COUNT] = {"Ride ID", "First Name", "Last Name", "Phone Number",
+                                                 "Pickup Location", "Dropoff Location", "Date of Ride",
+                                                 "Vehicle Type", "Status"};
+static const char* TABLE_TITLE = "| RIDE MANAGEMENT TABLE |";
+
+// yyyy-mm-dd into text, returning its length
+static size_t formatDate(const person& p, char* text) {
+    char* end = to_chars(text, text + 12, static_cast<unsigned>(p.rideYear)).ptr;
+    *end++ = '-';
+    *end++ = static_cast<char>('0' + p.rideMonth / 10);
+    *end++ = static_cast<char>('0' + p.rideMonth % 10);
+    *end++ = '-';
+    *end++ = static_cast<char>('0' + p.rideDay / 10);
+    *end++ = static_cast<char>('0' + p.rideDay % 10);
+    return static_cast<size_t>(end - text);
+}
+
+size_t RideTable::pageCount(size_t pageRows) const {
+    return max<size_t>(1, (rides.size() + pageRows - 1) / pageRows);
+}
+
+void RideTable::print(ostream& out) {
+    render(out, 0, rides.size(), 0, 1);
+}
+
+void RideTable::printPage(ostream& out, size_t page, size_t pageRows) {
+    size_t pages = pageCount(pageRows);
+    page = min(page, pages - 1);
+    size_t first = page * pageRows;
+    render(out, first, min(pageRows, rides.size() - min(first, rides.size())), page, pages);
+}
+
+void RideTable::cell(string_view value, size_t width) {
+    if (width + 1 > value.size()) buffer.append(width + 1 - value.size(), ' ');
+    buffer += value;
+    buffer += '|';
+}
+
+void RideTable::flush(ostream& out) {
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void RideTable::render(ostream& out, size_t first, size_t count, size_t page, size_t pages) {
+    // Every column as wide as its longest value, which the store keeps,
+    // or its title
+    RideStore::ColumnWidths longest = rides.columnWidths();
+    size_t widths[COLUMN_COUNT] = {longest.rideId, longest.firstName, longest.lastName, longest.phone,
+                                   longest.pickup, longest.dropoff, longest.date, longest.vehicle, longest.status};
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) widths[c] = max(widths[c], strlen(TITLES[c]));
+
+    // Each column adds its width, a leading space and a divider
+    size_t borderLength = COLUMN_COUNT * 2;
+    for (size_t width : widths) borderLength += width;
+    size_t titleLength = strlen(TABLE_TITLE);
+    size_t margin = borderLength > titleLength ? (borderLength - titleLength) / 2 : 0;
+
+    buffer.clear();
+    buffer.append(margin, ' ').append(titleLength, '-').append(margin, ' ') += '\n';
+    buffer.append(margin, ' ').append(TABLE_TITLE).append(margin, ' ') += '\n';
+    buffer.append(margin, ' ').append(titleLength, '-').append(margin, ' ') += '\n';
+    buffer.append(borderLength, '=') += '\n';
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) cell(TITLES[c], widths[c]);
+    buffer += '\n';
+    buffer.append(borderLength, '=') += '\n';
+
+    char date[24];
+    auto row = rides.atRow(first);
+    for (size_t i = 0; i < count; ++i, ++row) {
+        const person& p = *row;
+        cell(p.ride_id, widths[RideId]);
+        cell(p.fname, widths[FirstName]);
+        cell(p.lname, widths[LastName]);
+        cell(p.phone, widths[Phone]);
+        cell(p.pickupCity().name, widths[Pickup]);
+        cell(p.dropoffCity().name, widths[Dropoff]);
+        cell(string_view(date, formatDate(p, date)), widths[Date]);
+        cell(vehicleName(p.vehicle), widths[Vehicle]);
+        cell(statusName(p.status), widths[Status]);
+        buffer += '\n';
+        if (buffer.size() >= WRITE_BYTES) flush(out);
+    }
+
+    buffer.append(borderLength, '=') += '\n';
+    buffer += "\nTotal rides: ";
+    buffer += to_string(rides.size());
+    if (pages > 1) {
+        buffer += "  (page " + to_string(page + 1) + " of " + to_string(pages) + ", rides " +
+                  to_string(first + 1) + " to " + to_string(first + count) + ")";
+    }
+    buffer += '\n';
+    for (size_t i = 0; i < RIDE_STATUS_COUNT; ++i) {
+        RideStatus status = static_cast<RideStatus>(i);
+        buffer += i == 0 ? "" : " | ";
+        buffer += statusName(status);
+        buffer += ": ";
+        buffer += to_string(rides.countWithStatus(status));
+    }
+    buffer += "\n\n";
+    flush(out);
+    out.flush();
+}
+
+void printRideTable(const RideStore& rides, ostream& out) {
+    RideTable(rides).print(out);
+}
@@ -0,0 +1,46 @@
+#ifndef RIDE_TABLE_H
+#define RIDE_TABLE_H
+
+#include "ride_store.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+// The ride management table: a title, a header row, one row per ride
+// with columns sized to the longest value in the store, and the ride
+// counts in total and by status.
+//
+// Widths and counts are kept by the store, so only the rows shown are
+// read. They are formatted into a buffer kept between calls and written
+// out a large block at a time. A page costs the rows on it, however many
+// rides the store holds, and every page has the same column widths.
+class RideTable {
+public:
+    // Rows per page in the interactive view
+    static constexpr size_t PAGE_ROWS = 25;
+
+    explicit RideTable(const RideStore& rides) : rides(rides) {}
+
+    // Number of pages of pageRows rows, at least one
+    size_t pageCount(size_t pageRows = PAGE_ROWS) const;
+
+    // Every ride
+    void print(std::ostream& out);
+    // Page `page` (from 0)
+    void printPage(std::ostream& out, size_t page, size_t pageRows = PAGE_ROWS);
+
+private:
+    // Rows [first, first + count) and a footer
+    void render(std::ostream& out, size_t first, size_t count, size_t page, size_t pages);
+    // The value right-aligned in a column of width, then the divider
+    void cell(std::string_view value, size_t width);
+    void flush(std::ostream& out);
+
+    const RideStore& rides;
+    std::string buffer;
+};
+
+// The whole table, as view_all_rides() shows it for a single page
+void printRideTable(const RideStore& rides, std::ostream& out);
+
+#endif // RIDE_TABLE_H
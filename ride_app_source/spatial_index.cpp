@@ -0,0 +1,166 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static constexpr double EARTH_RADIUS_KM = 6371.0;
+static constexpr size_t LEAF_SIZE = 8;
+static constexpr size_t SOURCE_COUNT = static_cast<size_t>(CitySource::PNR) + 1;
+
+static void toUnitVector(double lat, double lon, double out[3]) {
+    constexpr double PI_DIV_180 = M_PI / 180.0;
+    double phi = lat * PI_DIV_180;
+    double lambda = lon * PI_DIV_180;
+    out[0] = cos(phi) * cos(lambda);
+    out[1] = cos(phi) * sin(lambda);
+    out[2] = sin(phi);
+}
+
+static inline double chordSquared(const double a[3], const double b[3]) {
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+static inline double chordToKm(double chord2) {
+    double half = min(1.0, sqrt(chord2) / 2.0);
+    return 2.0 * EARTH_RADIUS_KM * asin(half);
+}
+
+SpatialIndex::SpatialIndex(const vector<City>& cities) : cities(cities), trees(SOURCE_COUNT) {
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        Point point;
+        toUnitVector(cities[id].lat, cities[id].lon, point.xyz);
+        point.id = id;
+        point.axis = 0;
+        trees[static_cast<size_t>(cities[id].source)].push_back(point);
+    }
+    for (auto& tree : trees) {
+        build(tree, 0, tree.size());
+    }
+}
+
+void SpatialIndex::build(Tree& tree, size_t lo, size_t hi) {
+    if (hi - lo <= LEAF_SIZE) return;
+
+    // Split along the axis with the widest spread
+    double low[3] = {2, 2, 2}, high[3] = {-2, -2, -2};
+    for (size_t i = lo; i < hi; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            low[a] = min(low[a], tree[i].xyz[a]);
+            high[a] = max(high[a], tree[i].xyz[a]);
+        }
+    }
+    uint8_t axis = 0;
+    for (uint8_t a = 1; a < 3; ++a) {
+        if (high[a] - low[a] > high[axis] - low[axis]) axis = a;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    nth_element(tree.begin() + lo, tree.begin() + mid, tree.begin() + hi,
+                [axis](const Point& a, const Point& b) { return a.xyz[axis] < b.xyz[axis]; });
+    tree[mid].axis = axis;
+
+    build(tree, lo, mid);
+    build(tree, mid + 1, hi);
+}
+
+void SpatialIndex::searchNearest(const Tree& tree, size_t lo, size_t hi, const double q[3],
+                                 size_t k, vector<pair<double, uint32_t>>& heap) const {
+    auto consider = [&](const Point& point) {
+        double d = chordSquared(q, point.xyz);
+        if (heap.size() < k) {
+            heap.push_back({d, point.id});
+            push_heap(heap.begin(), heap.end());
+        } else if (d < heap.front().first) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = {d, point.id};
+            push_heap(heap.begin(), heap.end());
+        }
+    };
+
+    if (hi - lo <= LEAF_SIZE) {
+        for (size_t i = lo; i < hi; ++i) consider(tree[i]);
+        return;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    const Point& node = tree[mid];
+    consider(node);
+
+    // Near side first; the far side only if the split plane is closer
+    // than the current k-th best
+    double diff = q[node.axis] - node.xyz[node.axis];
+    bool left = diff < 0;
+    if (left) searchNearest(tree, lo, mid, q, k, heap);
+    else searchNearest(tree, mid + 1, hi, q, k, heap);
+
+    if (heap.size() < k || diff * diff < heap.front().first) {
+        if (left) searchNearest(tree, mid + 1, hi, q, k, heap);
+        else searchNearest(tree, lo, mid, q, k, heap);
+    }
+}
+
+void SpatialIndex::searchWithin(const Tree& tree, size_t lo, size_t hi, const double q[3],
+                                double limit, vector<pair<double, uint32_t>>& found) const {
+    if (hi - lo <= LEAF_SIZE) {
+        for (size_t i = lo; i < hi; ++i) {
+            double d = chordSquared(q, tree[i].xyz);
+            if (d <= limit) found.push_back({d, tree[i].id});
+        }
+        return;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    const Point& node = tree[mid];
+    double d = chordSquared(q, node.xyz);
+    if (d <= limit) found.push_back({d, node.id});
+
+    double diff = q[node.axis] - node.xyz[node.axis];
+    if (diff < 0 || diff * diff <= limit) searchWithin(tree, lo, mid, q, limit, found);
+    if (diff >= 0 || diff * diff <= limit) searchWithin(tree, mid + 1, hi, q, limit, found);
+}
+
+vector<SpatialIndex::Nearby> SpatialIndex::toNearby(vector<pair<double, uint32_t>>& hits) const {
+    sort(hits.begin(), hits.end());
+    vector<Nearby> result;
+    result.reserve(hits.size());
+    for (const auto& hit : hits) {
+        result.push_back({&cities[hit.second], chordToKm(hit.first)});
+    }
+    return result;
+}
+
+vector<SpatialIndex::Nearby> SpatialIndex::nearest(double lat, double lon, size_t k, SourceMask sources) const {
+    vector<pair<double, uint32_t>> heap;
+    if (k == 0) return {};
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+    // One heap across all selected trees, so each tree prunes against
+    // the best places found so far in any of them
+    for (size_t s = 0; s < trees.size(); ++s) {
+        if (sources & sourceBit(static_cast<CitySource>(s))) {
+            searchNearest(trees[s], 0, trees[s].size(), q, k, heap);
+        }
+    }
+    return toNearby(heap);
+}
+
+vector<SpatialIndex::Nearby> SpatialIndex::within(double lat, double lon, double radiusKm, SourceMask sources) const {
+    vector<pair<double, uint32_t>> found;
+    if (radiusKm < 0) return {};
+
+    double q[3];
+    toUnitVector(lat, lon, q);
+    double angle = min(M_PI, radiusKm / EARTH_RADIUS_KM);
+    double chord = 2.0 * sin(angle / 2.0);
+    for (size_t s = 0; s < trees.size(); ++s) {
+        if (sources & sourceBit(static_cast<CitySource>(s))) {
+            searchWithin(trees[s], 0, trees[s].size(), q, chord * chord, found);
+        }
+    }
+    return toNearby(found);
+}
@@ -0,0 +1,61 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "distance_calculator.h"
+#include <cstdint>
+#include <vector>
+
+// Set of CitySource values, one bit each
+using SourceMask = uint32_t;
+
+constexpr SourceMask sourceBit(CitySource source) {
+    return SourceMask(1) << static_cast<unsigned>(source);
+}
+
+constexpr SourceMask ALL_SOURCES = 0xFFFFFFFFu;
+constexpr SourceMask RAIL_STATIONS = sourceBit(CitySource::LRT) | sourceBit(CitySource::LRT2) |
+                                     sourceBit(CitySource::MRT3) | sourceBit(CitySource::PNR);
+
+// k-d tree over the catalog's coordinates, one tree per source file.
+// Points live on the unit sphere, where straight-line (chord) distance
+// orders places exactly like great-circle distance does.
+class SpatialIndex {
+public:
+    struct Nearby {
+        const City* city;
+        double distanceKm;
+    };
+
+    explicit SpatialIndex(const std::vector<City>& cities);
+
+    // The k places closest to (lat, lon), closest first
+    std::vector<Nearby> nearest(double lat, double lon, size_t k,
+                                SourceMask sources = ALL_SOURCES) const;
+
+    // Every place within radiusKm of (lat, lon), closest first
+    std::vector<Nearby> within(double lat, double lon, double radiusKm,
+                               SourceMask sources = ALL_SOURCES) const;
+
+private:
+    struct Point {
+        double xyz[3];
+        uint32_t id;
+        uint8_t axis;   // split axis when this point is a node's median
+    };
+
+    // Points of one source, arranged so that [lo, hi) is a subtree whose
+    // root is the median at lo + (hi - lo) / 2
+    using Tree = std::vector<Point>;
+
+    static void build(Tree& tree, size_t lo, size_t hi);
+    void searchNearest(const Tree& tree, size_t lo, size_t hi, const double q[3],
+                       size_t k, std::vector<std::pair<double, uint32_t>>& heap) const;
+    void searchWithin(const Tree& tree, size_t lo, size_t hi, const double q[3],
+                      double limit, std::vector<std::pair<double, uint32_t>>& found) const;
+    std::vector<Nearby> toNearby(std::vector<std::pair<double, uint32_t>>& hits) const;
+
+    const std::vector<City>& cities;
+    std::vector<Tree> trees;   // indexed by CitySource
+};
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,192 @@
+#include "transit_router.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+// Sources whose places are stops on the network
+static constexpr SourceMask TRANSIT_STOPS = RAIL_STATIONS | sourceBit(CitySource::MajorBus) |
+                                            sourceBit(CitySource::Ejeep);
+// Walking counts for more than riding, and changing lines costs extra
+static constexpr double WALK_FACTOR = 1.5;
+static constexpr double TRANSFER_PENALTY_KM = 0.5;
+static constexpr uint32_t NONE = numeric_limits<uint32_t>::max();
+
+const char* sourceName(CitySource source) {
+    switch (source) {
+        case CitySource::Cities:   return "City";
+        case CitySource::Ejeep:    return "E-jeep";
+        case CitySource::LRT2:     return "LRT-2";
+        case CitySource::LRT:      return "LRT-1";
+        case CitySource::MajorBus: return "Bus";
+        case CitySource::MRT3:     return "MRT-3";
+        case CitySource::PNR:      return "PNR";
+    }
+    return "Unknown";
+}
+
+const TransitRouter& TransitRouter::instance() {
+    static const TransitRouter router(CityCatalog::instance());
+    return router;
+}
+
+TransitRouter::TransitRouter(const CityCatalog& catalog) : catalog(catalog) {
+    const auto& cities = catalog.cities();
+    DistanceCalculator calculator;
+    vector<pair<uint32_t, Edge>> pending;
+
+    auto addEdge = [&](uint32_t a, uint32_t b, Mode mode, CitySource line, double km, double cost) {
+        pending.push_back({a, {b, mode, line, static_cast<float>(km), static_cast<float>(cost)}});
+        pending.push_back({b, {a, mode, line, static_cast<float>(km), static_cast<float>(cost)}});
+    };
+
+    // Line edges: catalog ids follow file order, so consecutive stations
+    // of a rail source are neighbours on the line
+    uint32_t previous = NONE;
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        bool rail = (RAIL_STATIONS & sourceBit(cities[id].source)) != 0;
+        if (rail && previous != NONE && cities[previous].source == cities[id].source) {
+            double km = calculator.calculateDistance(cities[previous], cities[id]);
+            addEdge(previous, id, Mode::Line, cities[id].source, km, km);
+        }
+        previous = rail ? id : NONE;
+    }
+
+    // Transfer edges between nearby stops of different sources
+    for (uint32_t id = 0; id < cities.size(); ++id) {
+        const City& stop = cities[id];
+        if (!(TRANSIT_STOPS & sourceBit(stop.source))) continue;
+
+        for (const auto& near : catalog.spatial().within(stop.lat, stop.lon, TRANSFER_KM, TRANSIT_STOPS)) {
+            uint32_t other = catalog.idOf(*near.city);
+            // Each pair once; same-source pairs are not transfers
+            if (other <= id || near.city->source == stop.source) continue;
+            double km = near.distanceKm;
+            addEdge(id, other, Mode::Transfer, stop.source, km, km * WALK_FACTOR + TRANSFER_PENALTY_KM);
+        }
+    }
+
+    // Compressed adjacency: edges grouped by their start
+    offsets.assign(cities.size() + 1, 0);
+    for (const auto& entry : pending) offsets[entry.first + 1]++;
+    for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+    edges.resize(pending.size());
+    vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto& entry : pending) edges[fill[entry.first]++] = entry.second;
+}
+
+bool TransitRouter::isStop(const City& place) const {
+    uint32_t id = catalog.idOf(place);
+    return offsets[id + 1] > offsets[id];
+}
+
+vector<pair<uint32_t, double>> TransitRouter::accessStops(const City& place) const {
+    vector<pair<uint32_t, double>> stops;
+    for (const auto& near : catalog.spatial().nearest(place.lat, place.lon, 8, TRANSIT_STOPS)) {
+        if (near.city == &place || !isStop(*near.city)) continue;
+        // Always keep the closest stop, even if it is a long walk
+        if (!stops.empty() && near.distanceKm > ACCESS_KM) break;
+        stops.push_back({catalog.idOf(*near.city), near.distanceKm});
+    }
+    return stops;
+}
+
+TransitRouter::Route TransitRouter::route(const City& from, const City& to) const {
+    Route result;
+    if (&from == &to) {
+        result.found = true;
+        return result;
+    }
+
+    const auto& cities = catalog.cities();
+    DistanceCalculator calculator;
+    const uint32_t n = static_cast<uint32_t>(cities.size());
+    const uint32_t start = catalog.idOf(from);
+    const uint32_t goal = catalog.idOf(to);
+    // Places off the network get a virtual node: the start walks to its
+    // access stops, and the goal's access stops walk to node n
+    const uint32_t target = isStop(to) ? goal : n;
+
+    struct Step {
+        uint32_t node;
+        Mode mode;
+        CitySource line;
+        double km;
+    };
+    vector<double> cost(n + 1, numeric_limits<double>::infinity());
+    vector<Step> via(n + 1, {NONE, Mode::Walk, CitySource::Cities, 0});
+    using Entry = pair<double, uint32_t>;   // (cost + heuristic, node)
+    priority_queue<Entry, vector<Entry>, greater<Entry>> open;
+
+    auto estimate = [&](uint32_t node) {
+        return (node == n) ? 0.0 : calculator.calculateDistance(cities[node], to);
+    };
+
+    if (isStop(from)) {
+        cost[start] = 0;
+        open.push({estimate(start), start});
+    } else {
+        for (const auto& [stop, km] : accessStops(from)) {
+            cost[stop] = km * WALK_FACTOR;
+            via[stop] = {start, Mode::Walk, CitySource::Cities, km};
+            open.push({cost[stop] + estimate(stop), stop});
+        }
+    }
+
+    vector<pair<uint32_t, double>> egress;
+    if (target == n) egress = accessStops(to);
+
+    while (!open.empty()) {
+        auto [priority, node] = open.top();
+        open.pop();
+        if (node == target) break;
+        if (priority > cost[node] + estimate(node) + 1e-9) continue;   // stale entry
+
+        auto relax = [&](uint32_t next, double stepCost, Step step) {
+            if (cost[node] + stepCost < cost[next]) {
+                cost[next] = cost[node] + stepCost;
+                via[next] = step;
+                open.push({cost[next] + estimate(next), next});
+            }
+        };
+
+        for (uint32_t e = offsets[node]; e < offsets[node + 1]; ++e) {
+            const Edge& edge = edges[e];
+            relax(edge.to, edge.cost, {node, edge.mode, edge.line, edge.km});
+        }
+        for (const auto& [stop, km] : egress) {
+            if (stop == node) relax(n, km * WALK_FACTOR, {node, Mode::Walk, CitySource::Cities, km});
+        }
+    }
+
+    if (via[target].node == NONE && target != start) return result;
+
+    // Walk back from the target, then merge runs on the same line into legs
+    vector<pair<uint32_t, Step>> hops;
+    for (uint32_t node = target; node != start && via[node].node != NONE; node = via[node].node) {
+        hops.push_back({node, via[node]});
+        if (via[node].node == start) break;
+    }
+    reverse(hops.begin(), hops.end());
+
+    result.found = true;
+    for (const auto& [node, step] : hops) {
+        const City* stepTo = (node == n) ? &to : &cities[node];
+        const City* stepFrom = (step.node == start) ? &from : &cities[step.node];
+        result.km += step.km;
+
+        if (step.mode == Mode::Line && !result.legs.empty()) {
+            Leg& last = result.legs.back();
+            if (last.mode == Mode::Line && last.line == step.line) {
+                last.to = stepTo;
+                last.stops++;
+                last.km += step.km;
+                continue;
+            }
+        }
+        result.legs.push_back({step.mode, step.line, stepFrom, stepTo, step.mode == Mode::Line ? 1 : 0, step.km});
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+#ifndef TRANSIT_ROUTER_H
+#define TRANSIT_ROUTER_H
+
+#include "city_catalog.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Display name of the line or network a source file describes
+const char* sourceName(CitySource source);
+
+// Routing over the rail and bus network. LRT.csv, LRT-2.csv, MRT-3.csv and
+// PNR.csv list stations in line order, so consecutive stations are joined
+// by line edges; stops of different sources within walking distance are
+// joined by transfer edges. Queries run A* with a haversine heuristic.
+class TransitRouter {
+public:
+    // How a leg of a route is travelled
+    enum class Mode { Line, Transfer, Walk };
+
+    struct Leg {
+        Mode mode;
+        CitySource line;    // for Mode::Line
+        const City* from;
+        const City* to;
+        int stops;          // stations passed on a line leg
+        double km;
+    };
+
+    struct Route {
+        bool found = false;
+        double km = 0;      // distance travelled, walking included
+        std::vector<Leg> legs;
+    };
+
+    // Stops of different lines closer than this are a transfer
+    static constexpr double TRANSFER_KM = 0.6;
+    // Places off the network walk to stops within this range
+    static constexpr double ACCESS_KM = 1.5;
+
+    // The shared router over CityCatalog::instance() (built on first use)
+    static const TransitRouter& instance();
+
+    explicit TransitRouter(const CityCatalog& catalog);
+
+    // Cheapest route between two catalog places
+    Route route(const City& from, const City& to) const;
+
+    // True if the place is a stop on the network
+    bool isStop(const City& place) const;
+
+    size_t edgeCount() const { return edges.size(); }
+
+private:
+    struct Edge {
+        uint32_t to;
+        Mode mode;
+        CitySource line;
+        float km;
+        float cost;     // km plus any transfer penalty, never below km
+    };
+
+    // Stops a place off the network can walk to, with walking km
+    std::vector<std::pair<uint32_t, double>> accessStops(const City& place) const;
+
+    const CityCatalog& catalog;
+    // Edges of city id i are edges[offsets[i] .. offsets[i + 1])
+    std::vector<uint32_t> offsets;
+    std::vector<Edge> edges;
+};
+
+#endif // TRANSIT_ROUTER_H
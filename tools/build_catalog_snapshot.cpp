@@ -0,0 +1,41 @@
+// Offline build step: compile the Data_Csv files into the binary catalog
+// snapshot the app maps at startup (Data_Csv/city_catalog.bin).
+// Re-run it whenever a CSV changes; until then the app sees the snapshot
+// as stale and parses the CSVs itself.
+//
+// Build from this folder and run from the repository root:
+//   g++ -std=c++17 -O2 -I../ride_app_source build_catalog_snapshot.cpp
+//       ../ride_app_source/city_catalog.cpp ../ride_app_source/csv_reader.cpp
+//       ../ride_app_source/mapped_file.cpp ../ride_app_source/name_index.cpp
+//       ../ride_app_source/distance_calculator.cpp ../ride_app_source/fuzzy_matcher.cpp
+//       ../ride_app_source/prefix_index.cpp ../ride_app_source/spatial_index.cpp
+//       ../ride_app_source/transit_router.cpp ../ride_app_source/rail_lines.cpp
+//       -o build_catalog_snapshot
+
+#include "city_catalog.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    auto start = chrono::steady_clock::now();
+    const CityCatalog& catalog = CityCatalog::instance();
+
+    if (catalog.size() == 0) {
+        cerr << "Error: No cities loaded, nothing to write" << endl;
+        return 1;
+    }
+
+    string path = catalog.snapshotPath();
+    if (!catalog.saveSnapshot(path)) {
+        cerr << "Error: Could not write " << path << endl;
+        return 1;
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << catalog.size() << " cities to " << path
+         << (catalog.loadedFromSnapshot() ? " (snapshot was already current)" : "")
+         << " in " << ms << " ms" << endl;
+    return 0;
+}
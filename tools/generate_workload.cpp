@@ -0,0 +1,416 @@
+// Synthetic load for the ride app: bookings and a driver roster at
+// production scale, the same every time for the same seed.
+//
+// Writes into the output folder:
+//   bookings.commands  book commands for ride_app --headless
+//   drivers.csv        a roster with vehicle and starting position columns,
+//                      loadable as Data_Csv/drivers.csv
+//   rides.snapshot     with --snapshot: the same bookings as a ride
+//                      snapshot, pending with no driver yet, loadable as
+//                      Data_Csv/rides.snapshot (with no rides-*.journal)
+//
+// Pickups and dropoffs come from the Data_Csv catalog, weighted so a few
+// places take most trips (Zipf, exponent --skew); pickups and dropoffs
+// have separate hotspots. Drivers start near pickup hotspots.
+//
+// Build from this folder and run from the repository root:
+//   g++ -std=c++17 -O2 -I../ride_app_source generate_workload.cpp
+//       ../ride_app_source/city_catalog.cpp ../ride_app_source/csv_reader.cpp
+//       ../ride_app_source/mapped_file.cpp ../ride_app_source/name_index.cpp
+//       ../ride_app_source/distance_calculator.cpp ../ride_app_source/fuzzy_matcher.cpp
+//       ../ride_app_source/prefix_index.cpp ../ride_app_source/spatial_index.cpp
+//       ../ride_app_source/transit_router.cpp ../ride_app_source/rail_lines.cpp
+//       ../ride_app_source/distance_matrix.cpp ../ride_app_source/batch_distance.cpp
+//       ../ride_app_source/driver_manager.cpp ../ride_app_source/driver_grid.cpp
+//       ../ride_app_source/batch_dispatcher.cpp ../ride_app_source/ride_store.cpp
+//       ../ride_app_source/ride_journal.cpp ../ride_app_source/ride_service.cpp
+//       -o generate_workload -pthread
+//
+//   generate_workload [--bookings 1000000] [--drivers 10000] [--seed 1]
+//                     [--start 2026-01-01] [--days 30] [--skew 1.0]
+//                     [--out workload] [--snapshot]
+
+#include "city_catalog.h"
+#include "ride_journal.h"
+#include "ride_service.h"
+#include "ride_store.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Output is written a buffer at a time
+static constexpr size_t WRITE_BYTES = 1 << 20;
+
+static const char* FIRST_NAMES[] = {
+    "Juan", "Maria", "Jose", "Ana", "Pedro", "Rosa", "Carlo", "Liza", "Miguel", "Sofia", "Gabriel", "Angelica",
+    "Rafael", "Kristine", "Paolo", "Camille", "Mark", "Jasmine", "Christian", "Nicole", "Joshua", "Patricia",
+    "Daniel", "Bea", "Andres", "Teresa", "Ramon", "Luz", "Emilio", "Carmela", "Ricardo", "Divina"};
+static const char* LAST_NAMES[] = {
+    "Dela Cruz", "Santos", "Reyes", "Bautista", "Garcia", "Mendoza", "Ramos", "Aquino", "Castillo", "Villanueva",
+    "Flores", "Gonzales", "Torres", "Rivera", "Navarro", "Domingo", "Salazar", "Mercado", "Pascual", "Soriano",
+    "Manalo", "Lim", "Tan", "Cruz", "Aguilar", "Fernandez", "Lopez", "Valdez", "Ocampo", "Marquez"};
+
+// Share of bookings per vehicle, in VehicleType order. The fleet uses the
+// same mix so supply follows demand.
+static const unsigned VEHICLE_WEIGHTS[VEHICLE_TYPE_COUNT] = {40, 14, 3, 8, 20, 6, 9};
+// Share of bookings by group size: 1, 2, 3, 4, then 5 to 8
+static const unsigned GROUP_WEIGHTS[] = {58, 22, 10, 6, 4};
+
+struct Options {
+    size_t bookings = 1000000;
+    size_t drivers = 10000;
+    uint64_t seed = 1;
+    int startDay = 1, startMonth = 1, startYear = 2026;
+    int days = 30;
+    double skew = 1.0;
+    string out = "workload";
+    bool snapshot = false;
+};
+
+// splitmix64: fixed arithmetic, so a seed gives the same workload with any
+// compiler or standard library (std:: distributions do not promise that)
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    // 0 to bound - 1
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+    // [0, 1)
+    double unit() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    uint64_t state;
+};
+
+// Picks indexes with given weights by binary search over their running sums
+class WeightedPick {
+public:
+    explicit WeightedPick(const vector<double>& weights) : cumulative(weights.size()) {
+        double sum = 0;
+        for (size_t i = 0; i < weights.size(); ++i) cumulative[i] = (sum += weights[i]);
+    }
+
+    uint32_t pick(Random& random) const {
+        double target = random.unit() * cumulative.back();
+        size_t at = upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+        return static_cast<uint32_t>(min(at, cumulative.size() - 1));
+    }
+
+private:
+    vector<double> cumulative;
+};
+
+// Zipf weights over the catalog in a shuffled order, so which places are
+// hot depends on the seed
+static vector<double> hotspotWeights(size_t places, double skew, Random& random) {
+    vector<uint32_t> rank(places);
+    for (uint32_t i = 0; i < places; ++i) rank[i] = i;
+    for (size_t i = places; i > 1; --i) swap(rank[i - 1], rank[random.below(static_cast<uint32_t>(i))]);
+
+    vector<double> weights(places);
+    for (size_t i = 0; i < places; ++i) weights[i] = 1.0 / pow(static_cast<double>(rank[i] + 1), skew);
+    return weights;
+}
+
+template <size_t N>
+static WeightedPick fromTable(const unsigned (&table)[N]) {
+    return WeightedPick(vector<double>(table, table + N));
+}
+
+// Collects output and writes it out a large block at a time
+class Output {
+public:
+    bool open(const fs::path& path) {
+        file = fopen(path.string().c_str(), "wb");
+        buffer.reserve(WRITE_BYTES + 4096);
+        return file != nullptr;
+    }
+    ~Output() { close(); }
+
+    bool close() {
+        if (!file) return true;
+        flush();
+        bool ok = !failed && fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+    Output& operator<<(string_view text) {
+        buffer += text;
+        if (buffer.size() >= WRITE_BYTES) flush();
+        return *this;
+    }
+    Output& operator<<(char c) {
+        buffer += c;
+        return *this;
+    }
+    Output& operator<<(uint64_t value) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return *this;
+    }
+    // Fixed point with `decimals` places
+    void fixed(double value, int decimals) {
+        char text[32];
+        int length = snprintf(text, sizeof(text), "%.*f", decimals, value);
+        buffer.append(text, static_cast<size_t>(length));
+    }
+
+private:
+    void flush() {
+        if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) failed = true;
+        buffer.clear();
+    }
+
+    FILE* file = nullptr;
+    string buffer;
+    bool failed = false;
+};
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar, and back.
+// Plain arithmetic rather than mktime(), so no time zone gets involved.
+static int64_t daysFromCivil(int year, int month, int day) {
+    int64_t y = year - (month <= 2);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yearOfEra = y - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void civilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t shifted = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * shifted + 2) / 5 + 1);
+    month = static_cast<int>(shifted < 10 ? shifted + 3 : shifted - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2));
+}
+
+// yyyy-mm-dd, a day that exists: it must come back unchanged from a round trip
+static bool parseDate(const char* text, int& day, int& month, int& year) {
+    if (sscanf(text, "%d-%d-%d", &year, &month, &day) != 3 || year < 1970 || year > 9999 || month < 1 ||
+        month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    int y, m, d;
+    civilFromDays(daysFromCivil(year, month, day), y, m, d);
+    return y == year && m == month && d == day;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--bookings") == 0 && hasValue) {
+            options.bookings = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--drivers") == 0 && hasValue) {
+            options.drivers = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--start") == 0 && hasValue) {
+            if (!parseDate(argv[++i], options.startDay, options.startMonth, options.startYear)) return false;
+        } else if (strcmp(argv[i], "--days") == 0 && hasValue) {
+            options.days = atoi(argv[++i]);
+            if (options.days < 1) return false;
+        } else if (strcmp(argv[i], "--skew") == 0 && hasValue) {
+            options.skew = atof(argv[++i]);
+            if (options.skew < 0) return false;
+        } else if (strcmp(argv[i], "--out") == 0 && hasValue) {
+            options.out = argv[++i];
+        } else if (strcmp(argv[i], "--snapshot") == 0) {
+            options.snapshot = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The calendar days from the start date on, as day, month and year
+static vector<tm> rideDays(const Options& options) {
+    vector<tm> days;
+    int64_t first = daysFromCivil(options.startYear, options.startMonth, options.startDay);
+    for (int i = 0; i < options.days; ++i) {
+        int year, month, dayOfMonth;
+        civilFromDays(first + i, year, month, dayOfMonth);
+        tm day = {};
+        day.tm_mday = dayOfMonth;
+        day.tm_mon = month - 1;
+        day.tm_year = year - 1900;
+        days.push_back(day);
+    }
+    return days;
+}
+
+static void writeDate(Output& out, const tm& day) {
+    char text[40];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d", day.tm_year + 1900, day.tm_mon + 1, day.tm_mday);
+    out << string_view(text);
+}
+
+// A mobile number, 09 and nine digits
+struct Phone {
+    char digits[16];
+    explicit Phone(Random& random) { snprintf(digits, sizeof(digits), "09%09u", random.below(1000000000)); }
+    string_view text() const { return string_view(digits, 11); }
+};
+
+static bool writeDrivers(const Options& options, const CityCatalog& catalog, const WeightedPick& pickups,
+                         const WeightedPick& vehicles, Random& random) {
+    Output out;
+    if (!out.open(fs::path(options.out) / "drivers.csv")) return false;
+
+    out << "rider_id,name,phone,age,rating,license_plate,vehicle,latitude,longitude\n";
+    for (size_t i = 0; i < options.drivers; ++i) {
+        const City& base = catalog.cities()[pickups.pick(random)];
+        VehicleType vehicle = static_cast<VehicleType>(vehicles.pick(random));
+
+        out << static_cast<uint64_t>(1001 + i) << ',' << FIRST_NAMES[random.below(32)] << ' '
+            << LAST_NAMES[random.below(30)] << ',' << Phone(random).text() << ',' << static_cast<uint64_t>(21 + random.below(45)) << ',';
+        out.fixed(3.0 + random.below(21) / 10.0, 1);
+
+        char plate[16];
+        snprintf(plate, sizeof(plate), ",%c%c%c %04u,", 'A' + random.below(26), 'A' + random.below(26),
+                 'A' + random.below(26), random.below(10000));
+        out << string_view(plate) << vehicleName(vehicle) << ',';
+        // Within about 2 km of the hotspot
+        out.fixed(base.lat + (random.unit() - 0.5) * 0.036, 6);
+        out << ',';
+        out.fixed(base.lon + (random.unit() - 0.5) * 0.036, 6);
+        out << '\n';
+    }
+    return out.close();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: " << argv[0] << " [--bookings n] [--drivers n] [--seed n] [--start yyyy-mm-dd]"
+             << " [--days n] [--skew s] [--out folder] [--snapshot]" << endl;
+        return 2;
+    }
+
+    const CityCatalog& catalog = CityCatalog::instance();
+    if (catalog.size() < 2) {
+        cerr << "Error: Need at least two places in the Data_Csv catalog" << endl;
+        return 1;
+    }
+    error_code ec;
+    fs::create_directories(options.out, ec);
+
+    auto start = chrono::steady_clock::now();
+    Random random(options.seed);
+    WeightedPick pickups(hotspotWeights(catalog.size(), options.skew, random));
+    WeightedPick dropoffs(hotspotWeights(catalog.size(), options.skew, random));
+    WeightedPick vehicles = fromTable(VEHICLE_WEIGHTS);
+    WeightedPick groups = fromTable(GROUP_WEIGHTS);
+    vector<tm> days = rideDays(options);
+
+    if (!writeDrivers(options, catalog, pickups, vehicles, random)) {
+        cerr << "Error: Could not write " << fs::path(options.out) / "drivers.csv" << endl;
+        return 1;
+    }
+
+    Output out;
+    if (!out.open(fs::path(options.out) / "bookings.commands")) {
+        cerr << "Error: Could not write " << fs::path(options.out) / "bookings.commands" << endl;
+        return 1;
+    }
+
+    RideStore store;
+    // Fare by vehicle and route; there are far fewer routes than bookings
+    unordered_map<uint64_t, double> fares;
+    if (options.snapshot) store.reserve(options.bookings);
+
+    // Ride ids look like the app's own: a time, then a sequence number. The
+    // time is noon UTC on the start date, the same in every time zone.
+    const uint64_t idBase = static_cast<uint64_t>(
+        daysFromCivil(options.startYear, options.startMonth, options.startDay) * 86400 + 12 * 3600);
+
+    out << "# " << static_cast<uint64_t>(options.bookings) << " bookings, seed " << options.seed << '\n';
+    for (size_t i = 0; i < options.bookings; ++i) {
+        uint32_t pickup = pickups.pick(random);
+        uint32_t dropoff = dropoffs.pick(random);
+        while (dropoff == pickup) dropoff = dropoffs.pick(random);
+        VehicleType vehicle = static_cast<VehicleType>(vehicles.pick(random));
+        const tm& day = days[random.below(static_cast<uint32_t>(days.size()))];
+        uint32_t group = groups.pick(random);
+        uint32_t persons = group < 4 ? group + 1 : 5 + random.below(4);
+        const char* firstName = FIRST_NAMES[random.below(32)];
+        const char* lastName = LAST_NAMES[random.below(30)];
+        string rideId = to_string(idBase + i / 16) + "_" + to_string(i);
+
+        Phone phone(random);
+
+        out << "book," << firstName << ',' << lastName << ',' << phone.text() << ',' << catalog.cities()[pickup].name << ','
+            << catalog.cities()[dropoff].name << ',' << vehicleName(vehicle) << ',';
+        writeDate(out, day);
+        out << ',' << static_cast<uint64_t>(persons) << ',' << rideId << '\n';
+
+        if (options.snapshot) {
+            person ride;
+            ride.ride_id = move(rideId);
+            ride.fname = firstName;
+            ride.lname = lastName;
+            ride.phone = phone.text();
+            ride.pickup = pickup;
+            ride.dropoff = dropoff;
+            ride.vehicle = vehicle;
+            ride.num_of_persons = static_cast<uint16_t>(persons);
+            ride.setDate(day.tm_mday, day.tm_mon + 1, day.tm_year + 1900);
+
+            uint64_t route = (static_cast<uint64_t>(vehicle) << 48) | (static_cast<uint64_t>(pickup) << 24) | dropoff;
+            auto cached = fares.find(route);
+            if (cached == fares.end()) {
+                double km, fare = 0;
+                RideService::quoteFare(ride, km, fare);
+                cached = fares.emplace(route, fare).first;
+            }
+            ride.totalFare = cached->second;
+            store.add(move(ride));
+        }
+    }
+    if (!out.close()) {
+        cerr << "Error: Could not write " << fs::path(options.out) / "bookings.commands" << endl;
+        return 1;
+    }
+
+    string snapshotPath = (fs::path(options.out) / "rides.snapshot").string();
+    if (options.snapshot && !RideJournal::saveSnapshot(snapshotPath, store, 0)) {
+        cerr << "Error: Could not write " << snapshotPath << endl;
+        return 1;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << options.bookings << " bookings and " << options.drivers << " drivers to "
+         << options.out << (options.snapshot ? " (with rides.snapshot)" : "") << " in " << seconds << " s ("
+         << static_cast<uint64_t>((options.bookings + options.drivers) / max(seconds, 1e-9)) << " rows/s)" << endl;
+    return 0;
+}